@@ -0,0 +1,304 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "core/exchange/market_data.h"
+#include "core/exchange/order_server_request.h"
+#include "core/exchange/order_server_response.h"
+#include "core/matching_engine/order_book.h"
+#include "core/matching_engine/order_book_sink.h"
+#include "core/workload/workload_generator.h"
+#include "lib/logger.h"
+#include "lib/tsc_clock.h"
+
+/**
+ * @file bench_order_book.cpp
+ * @brief Microbenchmarks of OrderBook::addOrder() and OrderBook::cancelOrder().
+ *
+ * Every benchmark times its operations with the TSC and reports, besides the time per
+ * iteration, the "ns/op" and "cycles/op" counters; cycles are TSC (reference) cycles. Each
+ * benchmark runs twice: with QueueBench an operation includes publishing its responses and
+ * market updates to the outgoing queues, as MatchingEngine::handleClientRequest() does, with
+ * IsolatedBench the messages are only counted. Building and clearing the book is not timed.
+ *
+ * Run a Release build on an isolated core, e.g.
+ *     taskset -c 3 ./benchmarks --benchmark_repetitions=5
+ */
+
+namespace {
+
+using namespace Exchange;
+
+constexpr TickerID TICKER = 0;
+constexpr Price BASE_PRICE = 10'000;
+
+/**
+ * @class OpTimer
+ * @brief Times sections of a benchmark iteration and reports the per-operation counters.
+ */
+class OpTimer {
+  public:
+    explicit OpTimer(benchmark::State& state) noexcept : state_(state) {}
+
+    ~OpTimer() {
+        if (nOps_) {
+            state_.counters["ns/op"] = static_cast<double>(utils::TscClock::ticksToNanos(nTicks_)) / static_cast<double>(nOps_);
+            state_.counters["cycles/op"] = static_cast<double>(nTicks_) / static_cast<double>(nOps_);
+        }
+        state_.SetItemsProcessed(static_cast<std::int64_t>(nOps_));
+    }
+
+    OpTimer(const OpTimer&) = delete;
+    OpTimer(OpTimer&&) = delete;
+    OpTimer& operator=(const OpTimer&) = delete;
+    OpTimer& operator=(OpTimer&&) = delete;
+
+    /**
+     * @brief Runs and times nOps operations, as the manual time of the current iteration.
+     */
+    template <typename Operations>
+    auto time(std::size_t nOps, Operations&& operations) -> void {
+        const auto start = utils::readTscOrdered();
+        operations();
+        const auto ticks = utils::readTscOrdered() - start;
+        state_.SetIterationTime(static_cast<double>(utils::TscClock::ticksToNanos(ticks)) * 1e-9);
+        nTicks_ += ticks;
+        nOps_ += nOps;
+    }
+
+  private:
+    benchmark::State& state_;
+    std::uint64_t nTicks_{0};
+    std::uint64_t nOps_{0};
+};
+
+/**
+ * @class BookBench
+ * @brief A fresh order book delivering its messages to a sink of the given type.
+ *
+ * With MatchingEngine::QueueSink the messages are staged in outgoing queues which are published
+ * and drained in place after each operation, as in the matching engine. With
+ * MatchingEngine::CountingSink the book is measured in isolation.
+ */
+template <typename Sink>
+class BookBench {
+  public:
+    BookBench() : book_(std::make_unique<MatchingEngine::BasicOrderBook<Sink>>(TICKER, getSink())) {}
+
+    auto add(ClientID clientId, OrderID orderId, Side side, Price price, Qty qty) noexcept -> void {
+        book_->addOrder(clientId, orderId, TICKER, side, price, qty);
+        publish();
+    }
+
+    auto cancel(ClientID clientId, OrderID orderId) noexcept -> void {
+        book_->cancelOrder(clientId, orderId, TICKER);
+        publish();
+    }
+
+  private:
+    static auto getSink() -> Sink& {
+        if constexpr (std::is_same_v<Sink, MatchingEngine::QueueSink>) {
+            static MatchingEngine::QueueSink sink{responses_, updates_};
+            return sink;
+        } else {
+            static Sink sink;
+            return sink;
+        }
+    }
+
+    static auto publish() noexcept -> void {
+        if constexpr (std::is_same_v<Sink, MatchingEngine::QueueSink>) {
+            getSink().publish();
+            drain(responses_);
+            drain(updates_);
+        }
+    }
+
+    template <typename Queue>
+    static auto drain(Queue& queue) noexcept -> void {
+        for (auto batch = queue.peekBatch(Types::MAX_CLIENT_UPDATES); !batch.empty(); batch = queue.peekBatch(Types::MAX_CLIENT_UPDATES)) {
+            queue.consume(batch.size());
+        }
+    }
+
+    inline static ClientResponseQueue responses_{Types::MAX_CLIENT_UPDATES};
+    inline static MarketUpdateQueue updates_{Types::MAX_MARKET_UPDATES};
+
+    std::unique_ptr<MatchingEngine::BasicOrderBook<Sink>> book_;
+};
+
+using QueueBench = BookBench<MatchingEngine::QueueSink>;
+using IsolatedBench = BookBench<MatchingEngine::CountingSink>;
+
+/**
+ * @brief Adds resting bids spread over state.range(0) price levels, none of them matching.
+ */
+template <typename Bench>
+void BM_AddOrderPassive(benchmark::State& state) {
+    constexpr std::size_t BATCH = 1024;
+    const auto nLevels = state.range(0);
+    Bench bench;
+    OpTimer timer(state);
+    OrderID nextOrderId = 1;
+
+    for (auto _ : state) {
+        const auto firstOrderId = nextOrderId;
+        timer.time(BATCH, [&]() {
+            for (std::size_t i = 0; i < BATCH; ++i, ++nextOrderId) {
+                bench.add(1, nextOrderId, Side::BUY, BASE_PRICE - static_cast<Price>(nextOrderId % nLevels), 10);
+            }
+        });
+        for (auto orderId = firstOrderId; orderId < nextOrderId; ++orderId) {
+            bench.cancel(1, orderId);
+        }
+    }
+}
+BENCHMARK(BM_AddOrderPassive<QueueBench>)->Arg(1)->Arg(32)->UseManualTime();
+BENCHMARK(BM_AddOrderPassive<IsolatedBench>)->Arg(1)->Arg(32)->UseManualTime();
+
+/**
+ * @brief Adds a buy order sweeping state.range(0) ask levels of one order each.
+ */
+template <typename Bench>
+void BM_AddOrderSweep(benchmark::State& state) {
+    const auto nLevels = state.range(0);
+    Bench bench;
+    OpTimer timer(state);
+    OrderID nextOrderId = 1;
+
+    for (auto _ : state) {
+        for (Price level = 1; level <= nLevels; ++level) {
+            bench.add(1, nextOrderId++, Side::SELL, BASE_PRICE + level, 10);
+        }
+        timer.time(1, [&]() {
+            bench.add(2, nextOrderId++, Side::BUY, BASE_PRICE + nLevels, static_cast<Qty>(10 * nLevels));
+        });
+    }
+}
+BENCHMARK(BM_AddOrderSweep<QueueBench>)->Arg(1)->Arg(4)->Arg(16)->Arg(64)->UseManualTime();
+BENCHMARK(BM_AddOrderSweep<IsolatedBench>)->Arg(1)->Arg(4)->Arg(16)->Arg(64)->UseManualTime();
+
+/// @brief Where in the queue of its price level the cancelled orders are
+enum class QueuePosition : std::int64_t { HEAD, MIDDLE, TAIL };
+
+/**
+ * @brief Cancels orders at the head, middle or tail of a 1024 order deep price level.
+ */
+template <typename Bench>
+void BM_CancelOrder(benchmark::State& state) {
+    constexpr std::size_t DEPTH = 1024;
+    constexpr std::size_t BATCH = 64;
+    const auto position = static_cast<QueuePosition>(state.range(0));
+    Bench bench;
+    OpTimer timer(state);
+    OrderID nextOrderId = 1;
+
+    // Order IDs of the level in time priority, with a few more levels around it
+    std::vector<OrderID> queue;
+    for (std::size_t i = 0; i < DEPTH; ++i) {
+        queue.push_back(nextOrderId);
+        bench.add(1, nextOrderId++, Side::BUY, BASE_PRICE, 10);
+    }
+    for (Price level = 1; level <= 8; ++level) {
+        bench.add(1, nextOrderId++, Side::BUY, BASE_PRICE - level, 10);
+    }
+
+    const std::size_t first = position == QueuePosition::HEAD ? 0 : position == QueuePosition::MIDDLE ? (DEPTH - BATCH) / 2 : DEPTH - BATCH;
+    for (auto _ : state) {
+        timer.time(BATCH, [&]() {
+            for (std::size_t i = first; i < first + BATCH; ++i) {
+                bench.cancel(1, queue[i]);
+            }
+        });
+        queue.erase(queue.begin() + static_cast<std::ptrdiff_t>(first), queue.begin() + static_cast<std::ptrdiff_t>(first + BATCH));
+        for (std::size_t i = 0; i < BATCH; ++i) {
+            queue.push_back(nextOrderId);
+            bench.add(1, nextOrderId++, Side::BUY, BASE_PRICE, 10);
+        }
+    }
+}
+BENCHMARK(BM_CancelOrder<QueueBench>)
+    ->ArgName("position")
+    ->Arg(static_cast<std::int64_t>(QueuePosition::HEAD))
+    ->Arg(static_cast<std::int64_t>(QueuePosition::MIDDLE))
+    ->Arg(static_cast<std::int64_t>(QueuePosition::TAIL))
+    ->UseManualTime();
+BENCHMARK(BM_CancelOrder<IsolatedBench>)
+    ->ArgName("position")
+    ->Arg(static_cast<std::int64_t>(QueuePosition::HEAD))
+    ->Arg(static_cast<std::int64_t>(QueuePosition::MIDDLE))
+    ->Arg(static_cast<std::int64_t>(QueuePosition::TAIL))
+    ->UseManualTime();
+
+/**
+ * @brief Generates a flow of 16 clients around BASE_PRICE, see Workload::WorkloadGenerator.
+ */
+auto generateFlow(std::size_t nRequests) -> std::vector<Workload::WorkloadRequest> {
+    Workload::WorkloadConfig config;
+    config.seed = 42;
+    config.initialMid = BASE_PRICE;
+    config.clients.clear();
+    for (ClientID clientId = 1; clientId <= 16; ++clientId) {
+        config.clients.push_back({.clientId = clientId});
+    }
+    Workload::WorkloadGenerator generator(config);
+    std::vector<Workload::WorkloadRequest> flow;
+    generator.generate(nRequests, flow);
+    return flow;
+}
+
+/**
+ * @brief Replays a generated mix of passive adds, cancels and aggressive orders.
+ */
+template <typename Bench>
+void BM_MixedFlow(benchmark::State& state) {
+    constexpr std::size_t FLOW_SIZE = 64 * 1024;
+    static const auto flow = generateFlow(FLOW_SIZE);
+    Bench bench;
+    OpTimer timer(state);
+    OrderID idOffset = 0;
+
+    for (auto _ : state) {
+        timer.time(flow.size(), [&]() {
+            for (const auto& [tArrival, request] : flow) {
+                if (request.type == OMEClientRequest::Type::CANCEL) {
+                    bench.cancel(request.clientId, request.orderId + idOffset);
+                } else {
+                    bench.add(request.clientId, request.orderId + idOffset, request.side, request.price, request.qty);
+                }
+            }
+        });
+        // Start each pass from an empty book, with new order IDs
+        for (const auto& [tArrival, request] : flow) {
+            if (request.type == OMEClientRequest::Type::NEW) {
+                bench.cancel(request.clientId, request.orderId + idOffset);
+            }
+        }
+        idOffset += FLOW_SIZE;
+    }
+}
+BENCHMARK(BM_MixedFlow<QueueBench>)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MixedFlow<IsolatedBench>)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!utils::TscClock::calibrate()) {
+        std::fputs("The benchmarks need an invariant TSC\n", stderr);
+        return 1;
+    }
+    utils::Logger::setLogLevel(utils::LogLevel::WARNING);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
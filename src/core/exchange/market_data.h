@@ -9,6 +9,7 @@
 #include <format>
 #include <cstdint>
 
+#include "lib/huge_page_allocator.h"
 #include "lib/lock_free_queue.h"
 #include "types.h"
 
@@ -109,10 +110,10 @@ struct MDPMarketUpdate {
 #pragma pack(pop) // Restore default alignment
 
 // Queue for updates from OrderMatchingEngine to MarketDataPublisher
-using MarketUpdateQueue = utils::LFQueue<OMEMarketUpdate>;
+using MarketUpdateQueue = utils::LFQueue<OMEMarketUpdate, utils::HugePageAllocator<OMEMarketUpdate>>;
 
 // Queue for updates from MarketDataPublisher to public exchange clients
-using MDPMarketUpdateQueue = utils::LFQueue<MDPMarketUpdate>;
+using MDPMarketUpdateQueue = utils::LFQueue<MDPMarketUpdate, utils::HugePageAllocator<MDPMarketUpdate>>;
 
 } // namespace Exchange
 
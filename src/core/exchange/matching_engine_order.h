@@ -8,8 +8,12 @@
 #include <array>
 #include <string>
 #include <format>
+#include <vector>
 
 #include "types.h"
+#include "lib/assertion.h"
+#include "lib/huge_page_allocator.h"
+#include "lib/open_addressing_map.h"
 
 namespace Exchange {
 
@@ -99,17 +103,172 @@ class Order {
     }
 };
 
+/// @brief Index of an order inside an OrderStore
+using OrderIndex = std::uint32_t;
+/// @brief Invalid value for OrderIndex, also terminates the free list of an OrderStore
+inline constexpr auto OrderIndex_INVALID = INVALID_ID<OrderIndex>;
+
+/**
+ * @struct HotOrder
+ * @brief Fields of a resting order read while matching and walking a price level
+ * @details Packed into 32 bytes so that two orders share a cache line. FIFO links are
+ * 32-bit indices into the owning OrderStore instead of 64-bit pointers.
+ */
+struct alignas(32) HotOrder {
+    Price price_{Price_INVALID};              ///< Ask or bid price_
+    Priority priority_{Priority_INVALID};     ///< Position in queue with respect to same price_ & side_
+    Qty qty_{Qty_INVALID};                    ///< Quantity still active in the order book
+    OrderIndex prev_{OrderIndex_INVALID};     ///< Previous order at the same price_ level
+    OrderIndex next_{OrderIndex_INVALID};     ///< Next order at the same price_ level, or next free slot
+    Side side_{Side::INVALID};                ///< Buy or sell side_, INVALID while the slot is free
+};
+static_assert(sizeof(HotOrder) == 32, "HotOrder should fill exactly half a cache line");
+
+/**
+ * @struct ColdOrder
+ * @brief Identifying fields of a resting order, only read when reporting on it
+ */
+struct ColdOrder {
+    TickerID tickerId_{TickerID_INVALID};       ///< Financial instrument identifier
+    ClientID clientId_{ClientID_INVALID};       ///< Market participant identifier
+    OrderID clientOrderId_{OrderID_INVALID};    ///< Order ID provided by the client
+    OrderID marketOrderId_{OrderID_INVALID};    ///< Unique market-wide order ID
+};
+
+/**
+ * @class OrderStore
+ * @brief Fixed-capacity storage for the resting orders of a book, split into hot and cold arrays
+ *
+ * Orders are addressed by 32-bit OrderIndex values. The HotOrder array holds what the matching
+ * loop touches for every order it walks, the parallel ColdOrder array holds what is only needed
+ * to build responses and market updates. Free slots are chained through HotOrder::next_, so
+ * allocation and deallocation are O(1). Both arrays live on prefaulted, locked huge pages.
+ */
+class OrderStore {
+  public:
+    /**
+     * @brief Constructs a store able to hold up to capacity orders.
+     * @param capacity The number of order slots to pre-allocate.
+     */
+    explicit OrderStore(std::size_t capacity) : hot_(checkCapacity(capacity)), cold_(capacity) {
+        for (std::size_t i = 0; i + 1 < capacity; ++i) {
+            hot_[i].next_ = static_cast<OrderIndex>(i + 1);
+        }
+        freeHead_ = capacity ? 0 : OrderIndex_INVALID;
+    }
+
+    OrderStore() = delete;
+    OrderStore(const OrderStore &) = delete;
+    OrderStore(OrderStore &&) = delete;
+    OrderStore &operator=(const OrderStore &) = delete;
+    OrderStore &operator=(OrderStore &&) = delete;
+
+    /**
+     * @brief Stores a new order, not yet linked to any price level.
+     * @return The index of the order, or OrderIndex_INVALID if the store is full.
+     */
+    [[nodiscard]] OrderIndex allocate(TickerID tickerId, ClientID clientId, OrderID clientOrderId, OrderID marketOrderId,
+                                      Side side, Price price, Qty qty, Priority priority) noexcept {
+        const auto index = freeHead_;
+        if (index == OrderIndex_INVALID) [[unlikely]] {
+            return OrderIndex_INVALID;
+        }
+
+        auto &hot = hot_[index];
+        freeHead_ = hot.next_;
+        hot = {price, priority, qty, OrderIndex_INVALID, OrderIndex_INVALID, side};
+        cold_[index] = {tickerId, clientId, clientOrderId, marketOrderId};
+        ++size_;
+        return index;
+    }
+
+    /**
+     * @brief Releases the slot of an order back to the store.
+     * @param index The index of the order to release.
+     */
+    void deallocate(OrderIndex index) noexcept {
+        ASSERT_CONDITION(index < hot_.size() && hot_[index].side_ != Side::INVALID, "Expected in-use order at index:{}", index);
+        hot_[index] = HotOrder{};
+        hot_[index].next_ = freeHead_;
+        freeHead_ = index;
+        --size_;
+    }
+
+    [[nodiscard]] HotOrder &hot(OrderIndex index) noexcept { return hot_[index]; }
+    [[nodiscard]] const HotOrder &hot(OrderIndex index) const noexcept { return hot_[index]; }
+    [[nodiscard]] ColdOrder &cold(OrderIndex index) noexcept { return cold_[index]; }
+    [[nodiscard]] const ColdOrder &cold(OrderIndex index) const noexcept { return cold_[index]; }
+
+    /**
+     * @brief Returns the number of orders currently stored.
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    /**
+     * @brief Returns the maximum number of orders the store can hold.
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept { return hot_.size(); }
+
+    /**
+     * @brief Converts the order at an index to a string representation
+     * @return A string containing all order details
+     */
+    [[nodiscard]] std::string toString(OrderIndex index) const {
+        const auto &hot = hot_[index];
+        const auto &cold = cold_[index];
+        return std::format("<Order>[ticker: {}, client: {}, oid_client: {}, oid_market: {}, "
+                           "side_: {}, price_: {}, qty_: {}, priority_: {}, prev_: {}, next_: {}]",
+                           tickerIdToStr(cold.tickerId_), clientIdToStr(cold.clientId_),
+                           orderIdToStr(cold.clientOrderId_), orderIdToStr(cold.marketOrderId_),
+                           sideToStr(hot.side_), priceToStr(hot.price_), qtyToStr(hot.qty_),
+                           priorityToStr(hot.priority_),
+                           orderIdToStr(hot.prev_ != OrderIndex_INVALID ? cold_[hot.prev_].marketOrderId_ : OrderID_INVALID),
+                           orderIdToStr(hot.next_ != OrderIndex_INVALID ? cold_[hot.next_].marketOrderId_ : OrderID_INVALID));
+    }
+
+  private:
+    /**
+     * @brief Checks that every slot can be addressed by an OrderIndex, before the arrays are allocated.
+     */
+    [[nodiscard]] static std::size_t checkCapacity(std::size_t capacity) noexcept {
+        ASSERT_CONDITION(capacity < OrderIndex_INVALID, "OrderStore capacity {} exceeds the OrderIndex range", capacity);
+        return capacity;
+    }
+
+    std::vector<HotOrder, utils::HugePageAllocator<HotOrder>> hot_;    ///< Matching-hot fields, indexed by OrderIndex
+    std::vector<ColdOrder, utils::HugePageAllocator<ColdOrder>> cold_; ///< Identifying fields, indexed by OrderIndex
+    OrderIndex freeHead_{OrderIndex_INVALID};   ///< First free slot, chained through HotOrder::next_
+    std::size_t size_{0};                       ///< Number of orders currently stored
+};
+
 /**
- * @typedef OrderMap
- * @brief Mapping of OrderIDs to Order entries in the matching engine
+ * @struct ClientOrderKey
+ * @brief Identifies an order by the market participant and the order ID it assigned
  */
-using OrderMap = std::array<Order *, Types::MAX_ORDER_IDS>;
+struct ClientOrderKey {
+    ClientID clientId{ClientID_INVALID};      ///< Market participant identifier
+    OrderID clientOrderId{OrderID_INVALID};   ///< Order ID provided by the client
+
+    bool operator==(const ClientOrderKey &) const = default;
+};
+
+/**
+ * @struct ClientOrderKeyHash
+ * @brief Hashes a ClientOrderKey for the client order index
+ */
+struct ClientOrderKeyHash {
+    [[nodiscard]] constexpr std::uint64_t operator()(const ClientOrderKey &key) const noexcept {
+        return utils::mixHash(key.clientOrderId + 0x9e3779b97f4a7c15ULL * key.clientId);
+    }
+};
 
 /**
  * @typedef ClientOrderMap
- * @brief Mapping of client IDs to OrderMaps to MatchingEngineOrders
+ * @brief Index of the live orders of a book by client ID and client order ID
+ * @details Sized to the number of orders the book can hold rather than to the range of client
+ * and order IDs, so it costs megabytes instead of gigabytes and accepts any client order ID.
  */
-using ClientOrderMap = std::array<OrderMap, Types::MAX_N_CLIENTS>;
+using ClientOrderMap = utils::OpenAddressingMap<ClientOrderKey, OrderIndex, ClientOrderKeyHash>;
 
 /**
  * @class OrdersAtPrice
@@ -130,11 +289,11 @@ class OrdersAtPrice {
      *
      * @param side Buy or sell side_
      * @param price The price_ level
-     * @param order_0 Pointer to the first order at this price_ level
+     * @param order_0 OrderStore index of the first order at this price_ level
      * @param prev Pointer to the previously more aggressive price_ level
      * @param next Pointer to the next_ more aggressive price_ level
      */
-    OrdersAtPrice(Side side, Price price, Order * order_0, OrdersAtPrice * prev, OrdersAtPrice * next) noexcept
+    OrdersAtPrice(Side side, Price price, OrderIndex order_0, OrdersAtPrice * prev, OrdersAtPrice * next) noexcept
         : side_(side), price_(price), order0_(order_0), prev_(prev), next_(next) {}
 
     /**
@@ -144,7 +303,7 @@ class OrdersAtPrice {
 
     Side side_{Side::INVALID};                         ///< Buy or sell side_
     Price price_{Price_INVALID};                       ///< Price level
-    Order * order0_{nullptr};             ///< Pointer to first order, sorted highest -> lowest priority_
+    OrderIndex order0_{OrderIndex_INVALID}; ///< OrderStore index of first order, sorted highest -> lowest priority_
     OrdersAtPrice * prev_{nullptr};       ///< Pointer to previously more aggressive price_ level
     OrdersAtPrice * next_{nullptr};       ///< Pointer to next_ more aggressive price_ level
 
@@ -154,7 +313,7 @@ class OrdersAtPrice {
      */
     [[nodiscard]] std::string toString() const {
         return std::format("<OrdersAtPrice>[side_: {}, price_: {}, order0_: {}, prev_: {}, next_: {}]",
-                           sideToStr(side_), priceToStr(price_), order0_ ? order0_->to_string() : "NULL",
+                           sideToStr(side_), priceToStr(price_), order0_ != OrderIndex_INVALID ? std::to_string(order0_) : "NULL",
                            priceToStr(prev_ ? prev_->price_ : Price_INVALID),
                            priceToStr(next_ ? next_->price_ : Price_INVALID));
     }
@@ -162,9 +321,9 @@ class OrdersAtPrice {
 
 /**
  * @typedef OrdersAtPriceMap
- * @brief Mapping of price_ levels to OrdersAtPrice
+ * @brief Mapping of the price_ levels inside the order book price window to OrdersAtPrice
  */
-using OrdersAtPriceMap = std::array<OrdersAtPrice *, Types::MAX_PRICE_LEVELS>;
+using OrdersAtPriceMap = std::array<OrdersAtPrice *, Types::PRICE_WINDOW_TICKS>;
 
 } // namespace Exchange
 
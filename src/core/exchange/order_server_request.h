@@ -9,7 +9,9 @@
 #include <cstdint>
 
 #include "types.h"
+#include "lib/huge_page_allocator.h"
 #include "lib/lock_free_queue.h"
+#include "request_timing.h"
 
 namespace Exchange {
 
@@ -37,9 +39,12 @@ struct OMEClientRequest {
      * @brief Enumeration of possible request types
      */
     enum class Type : std::uint8_t {
-        INVALID = 0, ///< Invalid or uninitialized request
-        NEW = 1,     ///< New order request
-        CANCEL = 2   ///< Cancel existing order request
+        INVALID = 0,   ///< Invalid or uninitialized request
+        NEW = 1,       ///< New limit order request, the unfilled quantity rests in the book
+        CANCEL = 2,    ///< Cancel existing order request
+        NEW_IOC = 3,   ///< New immediate-or-cancel order, the unfilled quantity is cancelled
+        NEW_FOK = 4,   ///< New fill-or-kill order, filled in full at once or cancelled
+        NEW_MARKET = 5 ///< New market order, price ignored, matched as IOC within Types::MARKET_PROTECTION_TICKS of the best price
     };
 
     Type type{Type::INVALID};               ///< Type of the request
@@ -65,6 +70,9 @@ struct OMEClientRequest {
             using enum Type;
         case NEW: return "NEW";
         case CANCEL: return "CANCEL";
+        case NEW_IOC: return "NEW_IOC";
+        case NEW_FOK: return "NEW_FOK";
+        case NEW_MARKET: return "NEW_MARKET";
         case INVALID: return "INVALID";
         default: return "UNKNOWN";
         }
@@ -100,11 +108,20 @@ struct OGSClientRequest {
 
 #pragma pack(pop) // Restore default alignment
 
+/**
+ * @struct QueuedClientRequest
+ * @brief A client request with the timestamps of its hops, as queued to the matching engine.
+ */
+struct QueuedClientRequest {
+    OMEClientRequest request; ///< The request
+    RequestTiming timing;     ///< Timestamps of the request so far
+};
+
 /**
  * @brief A lock-free queue for client requests
  * @details Used for passing requests from the Order Matching Engine to the Order Server
  */
-using ClientRequestQueue = utils::LFQueue<OMEClientRequest>;
+using ClientRequestQueue = utils::LFQueue<QueuedClientRequest, utils::HugePageAllocator<QueuedClientRequest>>;
 
 } // namespace Exchange
 
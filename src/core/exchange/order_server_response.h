@@ -11,7 +11,9 @@
 #include <format>
 
 #include "types.h"
+#include "lib/huge_page_allocator.h"
 #include "lib/lock_free_queue.h"
+#include "request_timing.h"
 
 namespace Exchange {
 
@@ -82,8 +84,17 @@ struct OGSClientResponse {
 
 #pragma pack(pop)
 
+/**
+ * @struct QueuedClientResponse
+ * @brief A response with the timestamps of the request it answers, as queued to the order server.
+ */
+struct QueuedClientResponse {
+    OMEClientResponse response; ///< The response
+    RequestTiming timing;       ///< Timestamps of the request up to the end of its matching
+};
+
 /// Queue for responses from OrderMatchingEngine to OrderServer
-using ClientResponseQueue = utils::LFQueue<OMEClientResponse>;
+using ClientResponseQueue = utils::LFQueue<QueuedClientResponse, utils::HugePageAllocator<QueuedClientResponse>>;
 
 } // namespace Exchange
 
@@ -0,0 +1,107 @@
+#ifndef LOW_LATENCY_TRADING_APP_REQUEST_TIMING_H
+#define LOW_LATENCY_TRADING_APP_REQUEST_TIMING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "lib/latency_histogram.h"
+#include "lib/logger.h"
+#include "lib/time_utils.h"
+
+namespace Exchange {
+
+/**
+ * @struct RequestTiming
+ * @brief Timestamps of a client request at each hop through the exchange.
+ *
+ * Travels with the request and its responses in the inter-thread queues, never on the wire.
+ * The timestamps are taken with utils::getCurrentNanos(), except tKernelRx, which comes from the
+ * kernel receive timestamp (microsecond precision) and is 0 when the socket provided none.
+ *
+ * The kernel stamps CLOCK_REALTIME, from which the TSC clock of getCurrentNanos() drifts: it
+ * follows CLOCK_MONOTONIC_RAW and ignores NTP slewing. So the gateway reads CLOCK_REALTIME once
+ * per receive and stores tKernelRx rebased onto the getCurrentNanos() timeline (see
+ * rebaseKernelTimestamp()). KERNEL_TO_GATEWAY is then measured entirely on the realtime clock,
+ * and END_TO_END and the traces subtract timestamps of one clock.
+ */
+struct RequestTiming {
+    utils::Nanos tKernelRx{0};   ///< Data received by the kernel
+    utils::Nanos tGatewayRx{0};  ///< Request decoded by the order gateway
+    utils::Nanos tSequenced{0};  ///< Request published to the matching engine by the FIFO sequencer
+    utils::Nanos tMatchStart{0}; ///< Request taken by the matching engine
+    utils::Nanos tMatchEnd{0};   ///< Responses of the request published by the matching engine
+    std::uint32_t traceId{0};    ///< ID of the sampled trace of the request, 0 if it is not traced
+    bool isFirstResponse{false}; ///< Set in the copy given to the first response of the request only
+};
+
+/**
+ * @brief Moves a kernel receive timestamp onto the utils::getCurrentNanos() timeline.
+ * @param tKernelRealtime The kernel receive timestamp, on CLOCK_REALTIME
+ * @param tRealtime CLOCK_REALTIME read at about the same time as tNow
+ * @param tNow utils::getCurrentNanos()
+ * @return The timestamp that is as far before tNow as tKernelRealtime is before tRealtime
+ */
+[[nodiscard]] constexpr auto rebaseKernelTimestamp(utils::Nanos tKernelRealtime, utils::Nanos tRealtime,
+                                                   utils::Nanos tNow) noexcept -> utils::Nanos {
+    return tNow - (tRealtime - tKernelRealtime);
+}
+
+/**
+ * @brief Hops of a client request with a latency histogram each.
+ */
+enum class LatencyStage : std::uint8_t {
+    KERNEL_TO_GATEWAY,        ///< tKernelRx to tGatewayRx
+    GATEWAY_TO_SEQUENCED,     ///< tGatewayRx to tSequenced
+    SEQUENCED_TO_MATCHING,    ///< tSequenced to tMatchStart
+    MATCHING,                 ///< tMatchStart to tMatchEnd
+    MATCHED_TO_RESPONSE_SENT, ///< tMatchEnd to the response queued on the client socket
+    END_TO_END,               ///< tKernelRx (or tGatewayRx) to the response queued on the client socket
+    COUNT
+};
+static_assert(static_cast<std::size_t>(LatencyStage::COUNT) <= utils::MAX_LATENCY_STAGES, "Too many latency stages");
+
+/**
+ * @brief Returns the display name of a latency stage.
+ */
+[[nodiscard]] constexpr auto latencyStageToStr(LatencyStage stage) noexcept -> std::string_view {
+    switch (stage) {
+        using enum LatencyStage;
+    case KERNEL_TO_GATEWAY: return "KERNEL_TO_GATEWAY";
+    case GATEWAY_TO_SEQUENCED: return "GATEWAY_TO_SEQUENCED";
+    case SEQUENCED_TO_MATCHING: return "SEQUENCED_TO_MATCHING";
+    case MATCHING: return "MATCHING";
+    case MATCHED_TO_RESPONSE_SENT: return "MATCHED_TO_RESPONSE_SENT";
+    case END_TO_END: return "END_TO_END";
+    case COUNT: break;
+    }
+    return "UNKNOWN";
+}
+
+/**
+ * @brief Records the latency of a stage from the calling thread.
+ */
+inline auto recordLatency(LatencyStage stage, utils::Nanos latency) noexcept -> void {
+    utils::LatencyMonitor::record(static_cast<std::size_t>(stage), latency);
+}
+
+/**
+ * @brief Logs the percentiles of every stage recorded since the start of the process.
+ */
+inline auto logLatencyReport() noexcept -> void {
+    for (std::size_t i = 0; i < static_cast<std::size_t>(LatencyStage::COUNT); ++i) {
+        utils::LatencyHistogram histogram;
+        utils::LatencyMonitor::collect(i, histogram);
+        if (!histogram.getCount()) {
+            continue;
+        }
+        LOG_INFO("Latency {} (ns): p50: {} p90: {} p99: {} p99.9: {} max: {} count: {}",
+                 latencyStageToStr(static_cast<LatencyStage>(i)),
+                 histogram.getPercentile(50.0), histogram.getPercentile(90.0), histogram.getPercentile(99.0),
+                 histogram.getPercentile(99.9), histogram.getMax(), histogram.getCount());
+    }
+}
+
+} // namespace Exchange
+
+#endif // LOW_LATENCY_TRADING_APP_REQUEST_TIMING_H
@@ -31,6 +31,8 @@ inline constexpr std::size_t OME_SIZE = 256;
 
 /// @brief Maximum number of trading instruments supported
 inline constexpr std::size_t MAX_TICKERS = 8;
+/// @brief Maximum number of matching engine threads, each matching a subset of the tickers
+inline constexpr std::size_t MAX_MATCHING_SHARDS = MAX_TICKERS;
 /// @brief Maximum number of client updates (matching requests and responses) that can be queued
 inline constexpr std::size_t MAX_CLIENT_UPDATES = OME_SIZE * 1024;
 /// @brief Maximum number of market updates that can be queued for publishing
@@ -41,6 +43,10 @@ inline constexpr std::size_t MAX_N_CLIENTS = OME_SIZE;
 inline constexpr std::size_t MAX_ORDER_IDS = 1024 * 1024;
 /// @brief Maximum depth of price levels in the order book
 inline constexpr std::size_t MAX_PRICE_LEVELS = OME_SIZE;
+/// @brief Number of ticks around the mid directly indexed by the order book price ladder (power of two)
+inline constexpr std::size_t PRICE_WINDOW_TICKS = 4 * OME_SIZE;
+/// @brief Ticks past the best opposite price a market order may trade at, its price protection
+inline constexpr std::size_t MARKET_PROTECTION_TICKS = 16;
 /// @brief Maximum number of pending requests on order gateway socket
 inline constexpr std::size_t MAX_PENDING_ORDER_REQUESTS = 1024;
 }
@@ -86,6 +92,11 @@ inline constexpr auto TickerID_INVALID = INVALID_ID<TickerID>;
     return numericToStr(id);
 }
 
+/// @brief Index of the matching engine shard handling a ticker, when the tickers are spread over nShards threads
+[[nodiscard]] constexpr auto getMatchingShard(TickerID id, std::size_t nShards) noexcept -> std::size_t {
+    return id % nShards;
+}
+
 /// @brief Type for unique client identification in the exchange
 using ClientID = std::uint32_t;
 /// @brief Invalid value for ClientID
@@ -2,12 +2,15 @@
 #define LOW_LATENCY_TRADING_APP_FIFO_SEQUENCER_H
 
 #include "../exchange/order_server_request.h"
+#include "../exchange/request_timing.h"
 #include "../exchange/types.h"
 #include "lib/assertion.h"
 #include "lib/logger.h"
 #include "lib/time_utils.h"
 #include <algorithm>
 #include <array>
+#include <span>
+#include <vector>
 
 namespace Exchange {
 
@@ -25,7 +28,17 @@ class FIFOSequencer {
      * @brief Construct a new FIFOSequencer
      * @param rxRequests Reference to the ClientRequestQueue for receiving requests
      */
-    explicit FIFOSequencer(ClientRequestQueue& rxRequests) noexcept : rxRequests_(rxRequests) {}
+    explicit FIFOSequencer(ClientRequestQueue& rxRequests) : rxRequests_{&rxRequests} {}
+
+    /**
+     * @brief Construct a FIFOSequencer for a sharded matching engine
+     * @param rxRequests The request queue of each matching engine shard, requests go to the
+     *                   shard of their ticker, see getMatchingShard()
+     */
+    explicit FIFOSequencer(std::span<ClientRequestQueue* const> rxRequests) : rxRequests_(rxRequests.begin(), rxRequests.end()) {
+        ASSERT_CONDITION(!rxRequests_.empty() && rxRequests_.size() <= Types::MAX_MATCHING_SHARDS,
+                         "<FIFOSequencer> Invalid number of matching engine shards: {}", rxRequests_.size());
+    }
 
     FIFOSequencer() = delete;
     FIFOSequencer(const FIFOSequencer&) = delete;
@@ -41,15 +54,21 @@ class FIFOSequencer {
             return;
         }
 
-        // Sort pending requests by their timestamps using a custom comparator
-        std::sort(pendingRequests_.begin(),
-                  pendingRequests_.begin() + nPendingRequests_,
-                  [](const PendingClientRequest& a, const PendingClientRequest& b) { return a.tRx < b.tRx; });
+        // Sort pending requests by their timestamps; requests read together share one, keep them in order
+        std::stable_sort(pendingRequests_.begin(),
+                         pendingRequests_.begin() + nPendingRequests_,
+                         [](const PendingClientRequest& a, const PendingClientRequest& b) { return a.tRx < b.tRx; });
 
+        const auto tSequenced = utils::getCurrentNanos();
         for (size_t i = 0; i < nPendingRequests_; ++i) {
             const auto& req = pendingRequests_[i];
-            LOG_INFO("Sequencing request: {} at tRx: {}", req.request.toStr(), req.tRx);
-            rxRequests_.push(req.request);
+            LOG_DEBUG("Sequencing request: {} at tRx: {}", req.request.toStr(), req.tRx);
+            if (req.tRx) [[likely]] {
+                recordLatency(LatencyStage::KERNEL_TO_GATEWAY, req.tGatewayRx - req.tRx);
+            }
+            recordLatency(LatencyStage::GATEWAY_TO_SEQUENCED, tSequenced - req.tGatewayRx);
+            auto& rxRequests = *rxRequests_[getMatchingShard(req.request.tickerId, rxRequests_.size())];
+            rxRequests.push({req.request, {req.tRx, req.tGatewayRx, tSequenced, 0, 0, req.traceId}});
         }
 
         nPendingRequests_ = 0;
@@ -58,13 +77,16 @@ class FIFOSequencer {
     /**
      * @brief Push a pending client order request onto the queue
      * @param request The client order request
-     * @param tRx The reception timestamp
+     * @param tRx The kernel reception timestamp, rebased onto utils::getCurrentNanos(), 0 if unavailable
+     * @param tGatewayRx The time the gateway decoded the request
+     * @param traceId The ID of the sampled trace of the request, 0 if it is not traced
      */
-    void pushClientRequest(const OMEClientRequest& request, utils::Nanos tRx) noexcept {
+    void pushClientRequest(const OMEClientRequest& request, utils::Nanos tRx, utils::Nanos tGatewayRx,
+                           std::uint32_t traceId = 0) noexcept {
         if (nPendingRequests_ >= pendingRequests_.size()) [[unlikely]] {
             FATAL("<FIFOSequencer> Too many pending requests!");
         }
-        pendingRequests_[nPendingRequests_] = {tRx, request};
+        pendingRequests_[nPendingRequests_] = {tRx, tGatewayRx, traceId, request};
         nPendingRequests_++;
     }
 
@@ -75,10 +97,12 @@ class FIFOSequencer {
      */
     struct PendingClientRequest {
         utils::Nanos tRx;
+        utils::Nanos tGatewayRx;
+        std::uint32_t traceId;
         OMEClientRequest request;
     };
 
-    ClientRequestQueue& rxRequests_;
+    std::vector<ClientRequestQueue*> rxRequests_; ///< Request queue of each matching engine shard
     std::array<PendingClientRequest, Exchange::Types::MAX_PENDING_ORDER_REQUESTS> pendingRequests_{};
     size_t nPendingRequests_{0};
 };
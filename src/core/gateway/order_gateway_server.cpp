@@ -4,6 +4,8 @@
 
 #include "order_gateway_server.h"
 
+#include <algorithm>
+
 #include "lib/logger.h"
 #include "lib/thread_utils.h"
 
@@ -11,14 +13,30 @@ namespace Exchange {
 
 OrderGatewayServer::OrderGatewayServer(ClientRequestQueue& txRequests,
                                        ClientResponseQueue& rxResponses,
-                                       std::string_view iface, int port) noexcept
-    : iface_(iface), port_(port), rxResponses_(rxResponses), fifo_(txRequests) {
+                                       std::string_view iface, int port,
+                                       utils::WaitStrategy waitStrategy)
+    : OrderGatewayServer(std::array{&txRequests}, std::array{&rxResponses}, iface, port, waitStrategy) {}
+
+OrderGatewayServer::OrderGatewayServer(std::span<ClientRequestQueue* const> txRequests,
+                                       std::span<ClientResponseQueue* const> rxResponses,
+                                       std::string_view iface, int port,
+                                       utils::WaitStrategy waitStrategy)
+    : iface_(iface), port_(port), rxResponses_(rxResponses.begin(), rxResponses.end()),
+      tracer_(RequestTracer::getInstance()), waitStrategy_(waitStrategy),
+      responseSignal_(std::make_unique<utils::WaitSignal>()), fifo_(txRequests) {
+    ASSERT_CONDITION(txRequests.size() == rxResponses.size(), "<OGS> {} request queues for {} response queues",
+                     txRequests.size(), rxResponses.size());
     mapClientToTxNSeq_.fill(1);
     mapClientToRxNSeq_.fill(1);
     mapClientToSocket_.fill(nullptr);
 
     server_.setRecvCallback([this](auto socket, auto tRx) { rxCallback(socket, tRx); });
     server_.setRecvFinishedCallback([this]() { rxDoneCallback(); });
+    if (waitStrategy_ == utils::WaitStrategy::SPIN_PARK) {
+        for (auto* queue : rxResponses_) {
+            queue->setWaitSignal(responseSignal_.get());
+        }
+    }
 }
 
 OrderGatewayServer::~OrderGatewayServer() {
@@ -36,33 +54,77 @@ void OrderGatewayServer::start() noexcept {
 
 void OrderGatewayServer::stop() noexcept {
     isRunning_ = false;
+    responseSignal_->wake();
     if (serverThread_->joinable()) {
         serverThread_->join();
     }
 }
 
 void OrderGatewayServer::run() noexcept {
-    LOG_INFO("OrderGatewayServer running order gateway...");
+    LOG_INFO("OrderGatewayServer running order gateway with {} wait strategy...", utils::waitStrategyToStr(waitStrategy_));
+    utils::Waiter waiter(waitStrategy_, responseSignal_.get(), MAX_PARK);
+    const auto hasResponses = [this]() {
+        return !isRunning_ || std::ranges::any_of(rxResponses_, [](auto* rxResponses) { return !rxResponses->peekBatch(1).empty(); });
+    };
     while (isRunning_) {
+        hasReceived_ = false;
         server_.poll();
         server_.sendAndReceive();
 
-        for (auto res = rxResponses_.getNextToRead(); rxResponses_.size() && res; res = rxResponses_.getNextToRead()) {
-            auto& nSeqTxNext = mapClientToTxNSeq_[res->clientId];
+        // One batch per shard at a time, so that a busy shard does not hold back the others
+        bool isIdle = !hasReceived_;
+        for (bool hasSent = true; hasSent;) {
+            hasSent = false;
+            for (auto* rxResponses : rxResponses_) {
+                hasSent |= sendResponseBatch(*rxResponses);
+            }
+            isIdle &= !hasSent;
+        }
+
+        if (isIdle) {
+            waiter.idle(hasResponses);
+        } else {
+            waiter.reset();
+        }
+    }
+}
 
-            LOG_INFO("Processing client id {} with seq number {} and response: {}", res->clientId, nSeqTxNext, res->toStr());
-            ASSERT_CONDITION(mapClientToSocket_[res->clientId] != nullptr, "<OGS> missing socket for client: {}", res->clientId);
-            mapClientToSocket_[res->clientId]->send(&nSeqTxNext, sizeof(nSeqTxNext));
-            mapClientToSocket_[res->clientId]->send(res, sizeof(OMEClientResponse));
+bool OrderGatewayServer::sendResponseBatch(ClientResponseQueue& rxResponses) noexcept {
+    const auto batch = rxResponses.peekBatch(MAX_RESPONSE_BATCH);
+    if (batch.empty()) {
+        return false;
+    }
+    for (const auto& [res, timing] : batch) {
+        auto& nSeqTxNext = mapClientToTxNSeq_[res.clientId];
+
+        LOG_DEBUG("Processing client id {} with seq number {} and response: {}", res.clientId, nSeqTxNext, res.toStr());
+        ASSERT_CONDITION(mapClientToSocket_[res.clientId] != nullptr, "<OGS> missing socket for client: {}", res.clientId);
+        mapClientToSocket_[res.clientId]->send(&nSeqTxNext, sizeof(nSeqTxNext));
+        mapClientToSocket_[res.clientId]->send(&res, sizeof(OMEClientResponse));
 
-            rxResponses_.updateReadIndex();
+        ++nSeqTxNext;
+    }
 
-            ++nSeqTxNext;
+    // send() only queues the bytes, the whole batch reaches the socket in the next sendAndReceive()
+    const auto tSent = utils::getCurrentNanos();
+    for (const auto& response : batch) {
+        const auto& timing = response.timing;
+        // tMatchEnd is 0 for responses published early because they reached the end of the queue ring
+        if (timing.tMatchEnd) [[likely]] {
+            recordLatency(LatencyStage::MATCHED_TO_RESPONSE_SENT, tSent - timing.tMatchEnd);
         }
+        recordLatency(LatencyStage::END_TO_END, tSent - (timing.tKernelRx ? timing.tKernelRx : timing.tGatewayRx));
+        tracer_.complete(response, tSent);
     }
+    rxResponses.consume(batch.size());
+    return true;
 }
 
 void OrderGatewayServer::rxCallback(utils::TCPSocket* socket, utils::Nanos tRx) noexcept {
+    const auto tGatewayRx = utils::getCurrentNanos();
+    // The kernel timestamp is on CLOCK_REALTIME: measure its distance on that clock (see RequestTiming)
+    const auto tKernelRx = tRx ? rebaseKernelTimestamp(tRx, utils::getRealtimeNanos(), tGatewayRx) : 0;
+    hasReceived_ = true;
     LOG_INFO("Received {} bytes from socket: {}", socket->getNextRcvValidIndex(), socket->getSocketFd());
 
     // Available rx data should be at least one client request in size
@@ -70,7 +132,7 @@ void OrderGatewayServer::rxCallback(utils::TCPSocket* socket, utils::Nanos tRx)
         size_t i = 0;
         for (; i + sizeof(OGSClientRequest) <= socket->getNextRcvValidIndex(); i += sizeof(OGSClientRequest)) {
             auto req = reinterpret_cast<const OGSClientRequest*>(socket->getInboundData().data() + i);
-            LOG_INFO("Received OGSClientRequest: {}", req->toStr());
+            LOG_DEBUG("Received OGSClientRequest: {}", req->toStr());
 
             // Client's first order req; start tracking with a new socket mapping
             if (mapClientToSocket_[req->omeRequest.clientId] == nullptr) [[unlikely]] {
@@ -98,7 +160,7 @@ void OrderGatewayServer::rxCallback(utils::TCPSocket* socket, utils::Nanos tRx)
 
             // Increment client seq number and forward order to the exchange FIFO sequencer
             ++nSeqRxNext;
-            fifo_.pushClientRequest(req->omeRequest, tRx);
+            fifo_.pushClientRequest(req->omeRequest, tKernelRx, tGatewayRx, tracer_.sample());
         }
 
         std::memcpy((void*)socket->getInboundData().data(), socket->getInboundData().data() + i,
@@ -6,13 +6,17 @@
 #include <array>
 #include <thread>
 #include <atomic>
+#include <span>
+#include <vector>
 
 #include "core/exchange/order_server_request.h"
 #include "core/exchange/order_server_response.h"
 #include "fifo_Sequencer.h"
+#include "request_tracer.h"
 #include "lib/logger.h"
 #include "lib/tcp_server.h"
 #include "lib/tcp_socket.h"
+#include "lib/wait_strategy.h"
 
 namespace Exchange {
 
@@ -25,10 +29,25 @@ class OrderGatewayServer {
      * @param rxResponses Queue for receiving order responses from the matching engine
      * @param iface Network interface name to bind to
      * @param port Port the interface will listen on
+     * @param waitStrategy What the server thread does while it has nothing to send or receive
      */
     OrderGatewayServer(ClientRequestQueue& txRequests,
                        ClientResponseQueue& rxResponses,
-                       std::string_view iface, int port) noexcept;
+                       std::string_view iface, int port,
+                       utils::WaitStrategy waitStrategy = utils::WaitStrategy::BUSY_SPIN);
+
+    /**
+     * @brief Constructs an order server for a matching engine sharded by ticker.
+     * @param txRequests Request queue of each matching engine shard, see getMatchingShard()
+     * @param rxResponses Response queue of each matching engine shard, in the same order
+     * @param iface Network interface name to bind to
+     * @param port Port the interface will listen on
+     * @param waitStrategy What the server thread does while it has nothing to send or receive
+     */
+    OrderGatewayServer(std::span<ClientRequestQueue* const> txRequests,
+                       std::span<ClientResponseQueue* const> rxResponses,
+                       std::string_view iface, int port,
+                       utils::WaitStrategy waitStrategy = utils::WaitStrategy::BUSY_SPIN);
 
     ~OrderGatewayServer();
 
@@ -60,14 +79,29 @@ class OrderGatewayServer {
     void rxDoneCallback() noexcept;
 
   private:
+    /// Maximum number of responses sent before their queue slots are released
+    static constexpr std::size_t MAX_RESPONSE_BATCH = 64;
+    /// Longest park with WaitStrategy::SPIN_PARK, the sockets are not signalled and are polled at least this often
+    static constexpr std::chrono::nanoseconds MAX_PARK{50'000};
+
     /**
      * @brief The server thread's main working method.
      */
     void run() noexcept;
 
+    /**
+     * @brief Sends up to MAX_RESPONSE_BATCH responses of a matching engine shard to their clients.
+     * @return False if the queue was empty.
+     */
+    bool sendResponseBatch(ClientResponseQueue& rxResponses) noexcept;
+
     const std::string iface_;
     const int port_;
-    ClientResponseQueue& rxResponses_;
+    std::vector<ClientResponseQueue*> rxResponses_; ///< Response queue of each matching engine shard
+    RequestTracer& tracer_;
+    const utils::WaitStrategy waitStrategy_;
+    std::unique_ptr<utils::WaitSignal> responseSignal_; ///< Notified by the producers of rxResponses_ with WaitStrategy::SPIN_PARK
+    bool hasReceived_{false};                           ///< Whether data was received since the server thread last checked
     std::atomic<bool> isRunning_{false};
     std::unique_ptr<std::jthread> serverThread_;
 
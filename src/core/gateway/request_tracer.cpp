@@ -0,0 +1,92 @@
+#include "request_tracer.h"
+
+#include <algorithm>
+#include <format>
+#include <string>
+
+#include "lib/logger.h"
+
+namespace Exchange {
+
+RequestTracer& RequestTracer::getInstance() {
+    static RequestTracer instance;
+    return instance;
+}
+
+RequestTracer::RequestTracer() = default;
+
+RequestTracer::~RequestTracer() {
+    closeFile();
+}
+
+auto RequestTracer::open(std::string_view path) -> bool {
+    closeFile();
+    file_.open(std::string(path), std::ios::out | std::ios::trunc);
+    if (!file_) {
+        LOG_ERROR("<RequestTracer> Failed to open trace file: {}", path);
+        return false;
+    }
+    // The closing bracket is optional in the trace event format, the file stays loadable if the process dies
+    file_ << "[";
+    hasSpans_ = false;
+    return true;
+}
+
+auto RequestTracer::closeFile() -> void {
+    if (file_.is_open()) {
+        exportTraces();
+        file_ << "\n]\n";
+        file_.close();
+    }
+}
+
+auto RequestTracer::exportTraces() -> std::size_t {
+    if (!file_.is_open()) {
+        return 0;
+    }
+    std::size_t nExported = 0;
+    for (auto batch = traces_.peekBatch(TRACE_RING_SIZE); !batch.empty(); batch = traces_.peekBatch(TRACE_RING_SIZE)) {
+        for (const auto& trace : batch) {
+            const auto& timing = trace.timing;
+            // The hops the responses of a request share are written once, with its first response: the
+            // responses of other requests may come in between, as batches are published per shard
+            if (timing.isFirstResponse) {
+                if (timing.tKernelRx) {
+                    writeSpan(latencyStageToStr(LatencyStage::KERNEL_TO_GATEWAY), trace, timing.tKernelRx, timing.tGatewayRx, false);
+                }
+                writeSpan(latencyStageToStr(LatencyStage::GATEWAY_TO_SEQUENCED), trace, timing.tGatewayRx, timing.tSequenced, false);
+                writeSpan(latencyStageToStr(LatencyStage::SEQUENCED_TO_MATCHING), trace, timing.tSequenced, timing.tMatchStart, false);
+                writeSpan(latencyStageToStr(LatencyStage::MATCHING), trace, timing.tMatchStart, timing.tMatchEnd, false);
+            }
+            if (timing.tMatchEnd) {
+                writeSpan(OMEClientResponse::typeToStr(trace.response.type), trace, timing.tMatchEnd, trace.tSent, true);
+            }
+        }
+        nExported += batch.size();
+        traces_.consume(batch.size());
+    }
+    file_.flush();
+    return nExported;
+}
+
+auto RequestTracer::writeSpan(std::string_view name, const RequestTrace& trace, utils::Nanos tStart, utils::Nanos tEnd,
+                              bool isResponse) -> void {
+    // Complete event ("X") with timestamps in microseconds, on the row of the trace
+    const auto traceId = trace.timing.traceId;
+    const auto duration = std::max<utils::Nanos>(tEnd - tStart, 0);
+    file_ << std::format("{}\n{{\"name\":\"{}\",\"cat\":\"request\",\"ph\":\"X\",\"ts\":{}.{:03},\"dur\":{}.{:03},"
+                         "\"pid\":1,\"tid\":{},\"args\":{{\"traceId\":{}",
+                         hasSpans_ ? "," : "", name, tStart / 1000, tStart % 1000, duration / 1000, duration % 1000,
+                         traceId, traceId);
+    if (isResponse) {
+        // Copies of the packed fields, std::format takes its arguments by reference
+        const auto clientId = trace.response.clientId;
+        const auto tickerId = trace.response.tickerId;
+        const auto orderId = trace.response.clientOrderId;
+        file_ << std::format(",\"clientId\":{},\"tickerId\":{},\"clientOrderId\":{}", clientId, tickerId, orderId);
+    }
+    file_ << "}}";
+    hasSpans_ = true;
+}
+
+} // namespace Exchange
@@ -0,0 +1,131 @@
+#ifndef LOW_LATENCY_TRADING_APP_REQUEST_TRACER_H
+#define LOW_LATENCY_TRADING_APP_REQUEST_TRACER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string_view>
+
+#include "core/exchange/order_server_response.h"
+#include "core/exchange/request_timing.h"
+#include "lib/lock_free_queue.h"
+#include "lib/time_utils.h"
+
+namespace Exchange {
+
+/// @brief Number of completed traces waiting for export before new ones are dropped
+inline constexpr std::size_t TRACE_RING_SIZE = 64 * 1024;
+
+/**
+ * @struct RequestTrace
+ * @brief Timeline of a sampled request up to one of its responses.
+ */
+struct RequestTrace {
+    RequestTiming timing;       ///< Timestamps of the request, timing.traceId identifies it
+    OMEClientResponse response; ///< The response
+    utils::Nanos tSent{0};      ///< Response queued on the client socket
+};
+
+/**
+ * @class RequestTracer
+ * @brief Samples 1 in N client requests and exports their timelines in the Chrome trace event format.
+ *
+ * The order gateway thread gives a trace ID to sampled requests with sample(), the ID travels
+ * in their RequestTiming through the matching engine, and the gateway thread hands every
+ * response of a traced request back with complete(). Completed traces go through a lock-free
+ * ring to exportTraces(), called from a background thread, which appends them to a JSON file
+ * loadable in chrome://tracing and Perfetto: one row per trace, one span per hop.
+ *
+ * Traces completed while the ring is full are dropped and counted.
+ */
+class RequestTracer {
+  public:
+    /**
+     * @brief Returns the process-wide tracer.
+     */
+    static RequestTracer& getInstance();
+
+    /**
+     * @brief Exports the remaining traces and completes the trace file.
+     */
+    ~RequestTracer();
+
+    RequestTracer(const RequestTracer&) = delete;
+    RequestTracer(RequestTracer&&) = delete;
+    RequestTracer& operator=(const RequestTracer&) = delete;
+    RequestTracer& operator=(RequestTracer&&) = delete;
+
+    /**
+     * @brief Sets the sampling rate, callable from any thread.
+     * @param interval Trace one request in interval, 0 to disable tracing (the default).
+     */
+    auto setSampleInterval(std::uint32_t interval) noexcept -> void {
+        sampleInterval_.store(interval, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Decides whether to trace the next request. Order gateway thread only.
+     * @return The trace ID of the request, 0 if it is not traced.
+     */
+    [[nodiscard]] auto sample() noexcept -> std::uint32_t {
+        const auto interval = sampleInterval_.load(std::memory_order_relaxed);
+        if (!interval || ++nUnsampled_ < interval) [[likely]] {
+            return 0;
+        }
+        nUnsampled_ = 0;
+        return ++lastTraceId_ ? lastTraceId_ : ++lastTraceId_;
+    }
+
+    /**
+     * @brief Records the timeline of a traced request up to one of its responses. Order gateway thread only.
+     * @param response The response and the timing of its request, ignored if the request is not traced.
+     * @param tSent The time the response was queued on the client socket.
+     */
+    auto complete(const QueuedClientResponse& response, utils::Nanos tSent) noexcept -> void {
+        if (!response.timing.traceId) [[likely]] {
+            return;
+        }
+        if (!traces_.push({response.timing, response.response, tSent})) [[unlikely]] {
+            nDropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Starts a new trace file, completing the previous one.
+     * @return False if the file cannot be opened.
+     */
+    [[nodiscard]] auto open(std::string_view path) -> bool;
+
+    /**
+     * @brief Appends the traces completed so far to the trace file. Single background thread.
+     * @return The number of traces exported.
+     */
+    auto exportTraces() -> std::size_t;
+
+    /**
+     * @brief Returns the number of traces dropped because the ring was full.
+     */
+    [[nodiscard]] auto getDroppedCount() const noexcept -> std::uint64_t {
+        return nDropped_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    RequestTracer();
+
+    auto closeFile() -> void;
+    auto writeSpan(std::string_view name, const RequestTrace& trace, utils::Nanos tStart, utils::Nanos tEnd, bool isResponse) -> void;
+
+    utils::LFQueue<RequestTrace> traces_{TRACE_RING_SIZE}; ///< Completed traces waiting for export
+    std::atomic<std::uint32_t> sampleInterval_{0};          ///< Trace one request in this many, 0 to disable
+    std::uint32_t nUnsampled_{0};                           ///< Requests since the last sampled one, gateway-owned
+    std::uint32_t lastTraceId_{0};                          ///< Last trace ID given, gateway-owned
+    std::atomic<std::uint64_t> nDropped_{0};                ///< Traces dropped because the ring was full
+
+    std::ofstream file_;                                    ///< Trace file, exporter-owned
+    bool hasSpans_{false};                                  ///< Whether the trace file has spans, exporter-owned
+};
+
+} // namespace Exchange
+
+#endif // LOW_LATENCY_TRADING_APP_REQUEST_TRACER_H
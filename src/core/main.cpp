@@ -5,39 +5,25 @@
 #include "lib/logger.h"
 #include "lib/tcp_server.h"
 #include "lib/tcp_socket.h"
+#include "lib/tsc_clock.h"
 
 #include "core/exchange/market_data.h"
 #include "core/exchange/order_server_request.h"
 #include "core/exchange/order_server_response.h"
+#include "core/exchange/request_timing.h"
 #include "core/exchange/types.h"
 #include "core/matching_engine/matching_engine.h"
 #include "core/gateway/order_gateway_server.h"
+#include "core/gateway/request_tracer.h"
 
 #include <csignal>
+#include <deque>
 #include <memory>
 #include <string>
 #include <thread>
 #include <unistd.h>
-//#include <benchmark/benchmark.h>
-//
-//static void BM_LOGGING(benchmark::State& state) {
-//    for (auto _ : state) {
-//        std::string msg = "This is an info message";
-//        msg = std::format("babab {}", msg);
-//    }
-//}
-//BENCHMARK(BM_LOGGING);
-//
-//static void BM_LOGGINGF(benchmark::State& state) {
-//    for (auto _ : state) {
-//        LOG_INFO("This is an {} info message with a formatted value: {}", 56, "formatted");
-//
-//    }
-//}
-//BENCHMARK(BM_LOGGINGF);
-//
-//BENCHMARK_MAIN();
-//
+#include <vector>
+
 void shutdown_handler(int) {
     using namespace std::literals::chrono_literals;
     std::this_thread::sleep_for(5s);
@@ -49,24 +35,48 @@ int main(int, char **) {
     using namespace utils;
     std::signal(SIGINT, shutdown_handler);
 
-    ClientRequestQueue client_requests{ Types::MAX_CLIENT_UPDATES };
-    ClientResponseQueue client_responses{ Types::MAX_CLIENT_UPDATES };
-    MarketUpdateQueue market_updates{ Types::MAX_MARKET_UPDATES };
-
-    // start the matching engine
-    LOG_INFO("Starting matching engine...");
+    if (!TscClock::calibrate()) {
+        LOG_WARNING("No invariant TSC, timestamps use the system clock");
+    }
 
+    // trace 1 in 1024 requests, exported with the latency report
+    auto& tracer = RequestTracer::getInstance();
+    if (tracer.open("exchange_trace.json")) {
+        tracer.setSampleInterval(1024);
+    }
 
+    // the tickers are spread over the matching engine shards, each with its own queues and core
+    const std::size_t n_matching_shards{ 2 };
+    const auto n_cores = std::thread::hardware_concurrency();
+    std::deque<ClientRequestQueue> client_requests;
+    std::deque<ClientResponseQueue> client_responses;
+    std::deque<MarketUpdateQueue> market_updates;
+    std::vector<std::unique_ptr<MatchingEngine::MatchingEngine>> omes;
 
-   auto ome = std::make_unique<MatchingEngine::MatchingEngine>(client_requests,
-                                                               client_responses,
-                                                               market_updates);
-    ome->startMatchingEngine();
+    // start the matching engine
+    LOG_INFO("Starting {} matching engine shards...", n_matching_shards);
+    for (std::size_t shard = 0; shard < n_matching_shards; ++shard) {
+        // core 0 is left to the gateway and the main loop, shards are not pinned if there are not enough cores
+        const int core = shard + 1 < n_cores ? static_cast<int>(shard + 1) : -1;
+        // a pinned shard owns its core and busy-spins, an unpinned one shares cores and parks when idle
+        const auto wait_strategy = core >= 0 ? WaitStrategy::BUSY_SPIN : WaitStrategy::SPIN_PARK;
+        omes.push_back(std::make_unique<MatchingEngine::MatchingEngine>(client_requests.emplace_back(Types::MAX_CLIENT_UPDATES),
+                                                                        client_responses.emplace_back(Types::MAX_CLIENT_UPDATES),
+                                                                        market_updates.emplace_back(Types::MAX_MARKET_UPDATES),
+                                                                        MatchingEngine::MatchingShard{ shard, n_matching_shards, core, wait_strategy }));
+        omes.back()->startMatchingEngine();
+    }
     // main exchange superloop
     const int t_sleep{ 100 * 1000 };
-    while (true) {
+    const int n_loops_per_latency_report{ 100 }; // about every 10 s
+    for (int n_loops = 1;; ++n_loops) {
         LOG_INFO("Sleeping for some ms...");
         usleep(t_sleep);    // sleep which can be terminated by a SIGINT/etc.
+        TscClock::recalibrate();
+        if (n_loops % n_loops_per_latency_report == 0) {
+            logLatencyReport();
+            tracer.exportTraces();
+        }
     }
 
     return 0;
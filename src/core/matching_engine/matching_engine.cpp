@@ -1,5 +1,7 @@
 #include "matching_engine.h"
 
+#include <format>
+
 #include "lib/assertion.h"
 #include "lib/logger.h"
 #include "lib/thread_utils.h"
@@ -9,13 +11,22 @@ namespace MatchingEngine {
 
 MatchingEngine::MatchingEngine(Exchange::ClientRequestQueue& rxRequests,
                                Exchange::ClientResponseQueue& txResponses,
-                               Exchange::MarketUpdateQueue& txMarketUpdates) noexcept
-    : rxRequests_(rxRequests),
-      txResponses_(txResponses),
-      txMarketUpdates_(txMarketUpdates) {
-    //orderBookForTicker_.fill(nullptr);
+                               Exchange::MarketUpdateQueue& txMarketUpdates,
+                               MatchingShard shard) noexcept
+    : shard_(shard),
+      threadName_(shard.nShards > 1 ? std::format("OME-{}", shard.shardId) : "OME"),
+      rxRequests_(rxRequests),
+      sink_(txResponses, txMarketUpdates) {
+    ASSERT_CONDITION(shard.nShards > 0 && shard.nShards <= Exchange::Types::MAX_MATCHING_SHARDS && shard.shardId < shard.nShards,
+                     "MatchingEngine invalid shard {} of {}", shard.shardId, shard.nShards);
     for (size_t i = 0; i < orderBookForTicker_.size(); ++i) {
-        orderBookForTicker_[i] = std::make_unique<OrderBook>(static_cast<Exchange::TickerID>(i), *this);
+        const auto tickerId = static_cast<Exchange::TickerID>(i);
+        if (Exchange::getMatchingShard(tickerId, shard.nShards) == shard.shardId) {
+            orderBookForTicker_[i] = std::make_unique<OrderBook>(tickerId, sink_);
+        }
+    }
+    if (shard.waitStrategy == utils::WaitStrategy::SPIN_PARK) {
+        rxRequests_.setWaitSignal(&requestSignal_);
     }
 }
 
@@ -26,18 +37,30 @@ MatchingEngine::~MatchingEngine() {
 }
 
 void MatchingEngine::startMatchingEngine() noexcept {
-    matchingEngineThread_ = utils::createAndStartThread(-1, "OME", [this]() { runMatchingEngine(); });
+    isRunning_.store(true, std::memory_order_relaxed);
+    matchingEngineThread_ = utils::createAndStartThread(shard_.coreId, threadName_, [this]() { runMatchingEngine(); });
     ASSERT_CONDITION(matchingEngineThread_ != nullptr, "MatchingEngine Failed to start thread for matching engine");
 }
 
 void MatchingEngine::stopMatchingEngine() noexcept {
     if (matchingEngineThread_ && matchingEngineThread_->joinable()) {
+        isRunning_.store(false, std::memory_order_relaxed);
+        requestSignal_.wake();
         matchingEngineThread_->request_stop();
         matchingEngineThread_->join();
     }
 }
 
 void MatchingEngine::handleClientRequest(const Exchange::OMEClientRequest& request) noexcept {
+    matchClientRequest(request);
+    publishPendingUpdates();
+}
+
+void MatchingEngine::matchClientRequest(const Exchange::OMEClientRequest& request) noexcept {
+    if (request.tickerId >= orderBookForTicker_.size() || !orderBookForTicker_[request.tickerId]) [[unlikely]] {
+        LOG_ERROR("Received request for ticker {} not matched by shard {}", Exchange::tickerIdToStr(request.tickerId), shard_.shardId);
+        return;
+    }
     switch (request.type) {
         using namespace Exchange;
 
@@ -48,6 +71,22 @@ void MatchingEngine::handleClientRequest(const Exchange::OMEClientRequest& reque
             request.price, request.qty
         );
         break;
+    case OMEClientRequest::Type::NEW_IOC:
+    case OMEClientRequest::Type::NEW_FOK:
+        orderBookForTicker_[request.tickerId]->addImmediateOrder(
+            request.clientId, request.orderId,
+            request.tickerId, request.side,
+            request.price, request.qty,
+            request.type == OMEClientRequest::Type::NEW_FOK
+        );
+        break;
+    case OMEClientRequest::Type::NEW_MARKET:
+        orderBookForTicker_[request.tickerId]->addMarketOrder(
+            request.clientId, request.orderId,
+            request.tickerId, request.side,
+            request.qty
+        );
+        break;
     case OMEClientRequest::Type::CANCEL:
         orderBookForTicker_[request.tickerId]->cancelOrder(
             request.clientId, request.orderId,
@@ -59,30 +98,40 @@ void MatchingEngine::handleClientRequest(const Exchange::OMEClientRequest& reque
     }
 }
 
-void MatchingEngine::dispatchClientResponse(const Exchange::OMEClientResponse& response) noexcept {
-    LOG_INFO("Publishing market update: {}", response.toStr());
-    if (!txResponses_.push(response)) [[unlikely]] {
-        LOG_ERROR("Failed to push client response to queue");
-    }
+void MatchingEngine::publishPendingUpdates() noexcept {
+    sink_.publish();
 }
 
-void MatchingEngine::publishMarketUpdate(const Exchange::OMEMarketUpdate& update) noexcept {
-    LOG_INFO("Publishing market update: {}", update.toStr());
-    if (!txMarketUpdates_.push(update)) [[unlikely]] {
-        LOG_ERROR("Failed to push market update to queue");
+bool MatchingEngine::handleRequestBatch() noexcept {
+    const auto requests = rxRequests_.peekBatch(MAX_REQUEST_BATCH);
+    if (requests.empty()) {
+        return false;
     }
+    for (const auto& request : requests) {
+        auto timing = request.timing;
+        timing.tMatchStart = utils::getCurrentNanos();
+        Exchange::recordLatency(Exchange::LatencyStage::SEQUENCED_TO_MATCHING, timing.tMatchStart - timing.tSequenced);
+        sink_.setTiming(timing);
+        LOG_DEBUG("rx request: {}", request.request.toStr());
+        matchClientRequest(request.request);
+        Exchange::recordLatency(Exchange::LatencyStage::MATCHING, utils::getCurrentNanos() - timing.tMatchStart);
+    }
+    // Release the request slots before publishing, so the gateway can refill them while the outputs are read
+    rxRequests_.consume(requests.size());
+    publishPendingUpdates();
+    return true;
 }
 
 void MatchingEngine::runMatchingEngine() noexcept {
-    isRunning_.store(true, std::memory_order_relaxed);
-    LOG_INFO("Matching engine thread started");
+    LOG_INFO("Matching engine thread started with {} wait strategy", utils::waitStrategyToStr(shard_.waitStrategy));
+    utils::Waiter waiter(shard_.waitStrategy, &requestSignal_);
     while (isRunning_.load(std::memory_order_relaxed)) {
-        if (auto request = rxRequests_.pop()) [[likely]] {
-            LOG_INFO("rx request: {} {}", utils::getCurrentTimeStr(), request->toStr());
-            handleClientRequest(*request);
+        if (handleRequestBatch()) [[likely]] {
+            waiter.reset();
+        } else {
+            waiter.idle([this]() { return rxRequests_.getNextToRead() || !isRunning_.load(std::memory_order_relaxed); });
         }
     }
-    isRunning_.store(false, std::memory_order_relaxed);
 }
 
 } // namespace MatchingEngine
\ No newline at end of file
@@ -9,18 +9,32 @@
 #include <thread>
 #include <memory>
 #include <atomic>
+#include <string>
 
 #include "../exchange/market_data.h"
 #include "../exchange/order_server_request.h"
 #include "../exchange/order_server_response.h"
+#include "../exchange/request_timing.h"
 #include "../exchange/types.h"
 #include "lib/lock_free_queue.h"
 #include "lib/logger.h"
+#include "lib/wait_strategy.h"
 
 #include "order_book.h"
 
 namespace MatchingEngine {
 
+/**
+ * @struct MatchingShard
+ * @brief Part of the tickers matched by a MatchingEngine, and where and how its thread runs.
+ */
+struct MatchingShard {
+    std::size_t shardId{0}; ///< Index of the shard, the engine matches the tickers t with getMatchingShard(t, nShards) == shardId
+    std::size_t nShards{1}; ///< Number of shards the tickers are spread over
+    int coreId{-1};         ///< Core the matching thread is pinned to, -1 to not pin it
+    utils::WaitStrategy waitStrategy{utils::WaitStrategy::BUSY_SPIN}; ///< What the matching thread does while no request is queued
+};
+
 /**
  * @class MatchingEngine
  * @brief Primary exchange component for matching bid and ask orders from market participants.
@@ -28,6 +42,10 @@ namespace MatchingEngine {
  * Runs on a dedicated thread, maintaining order books for each supported instrument.
  * Receives and responds to client orders via the Order Gateway, and publishes data
  * by dispatching to the market data publisher.
+ *
+ * To scale with the number of tickers, several engines can each match a shard of the tickers
+ * on their own thread and queues; the gateway sends each request to the shard of its ticker,
+ * so the requests of a ticker are still matched in sequence order.
  */
 class MatchingEngine {
   public:
@@ -36,10 +54,12 @@ class MatchingEngine {
      * @param rxRequests Queue for receiving client order requests.
      * @param txResponses Queue for transmitting responses to client orders.
      * @param txMarketUpdates Queue for pushing market updates to the publisher.
+     * @param shard The tickers matched by this engine and the core of its thread, all tickers by default.
      */
     MatchingEngine(Exchange::ClientRequestQueue& rxRequests,
                    Exchange::ClientResponseQueue& txResponses,
-                   Exchange::MarketUpdateQueue& txMarketUpdates) noexcept;
+                   Exchange::MarketUpdateQueue& txMarketUpdates,
+                   MatchingShard shard = {}) noexcept;
 
     // Rule of five
     MatchingEngine(const MatchingEngine&) = delete;
@@ -54,27 +74,23 @@ class MatchingEngine {
     void startMatchingEngine() noexcept;
 
     /**
-     * @brief Stops the matching thread.
+     * @brief Stops the matching thread, waking it if parked.
      */
     void stopMatchingEngine() noexcept;
 
     /**
      * @brief Processes a client request received from the order gateway server.
+     * @details Publishes the responses and market updates of the request before returning.
      * @param request The client request to process.
      */
     void handleClientRequest(const Exchange::OMEClientRequest& request) noexcept;
 
     /**
-     * @brief Dispatches a response to a client via the order gateway server.
-     * @param response The response to send to the client.
-     */
-    void dispatchClientResponse(const Exchange::OMEClientResponse& response) noexcept;
-
-    /**
-     * @brief Dispatches a market update to the market data publisher.
-     * @param update The market update to dispatch.
+     * @brief Makes the responses and market updates staged so far by the books visible to their consumers.
+     * @details Called once per batch of up to MAX_REQUEST_BATCH requests, so a burst of requests
+     * and the messages they generate cost one index update per queue instead of one per message.
      */
-    void publishMarketUpdate(const Exchange::OMEMarketUpdate& update) noexcept;
+    void publishPendingUpdates() noexcept;
 
     /**
      * @brief Checks if the matching engine worker thread is running.
@@ -85,16 +101,33 @@ class MatchingEngine {
     }
 
   private:
+    /// Maximum number of requests matched before their outputs are published and their queue slots released
+    static constexpr std::size_t MAX_REQUEST_BATCH = 64;
+
     /**
      * @brief Runs the main matching engine loop.
-     * Processes client requests received from the rxRequests_ queue.
+     * Processes client requests received from the rxRequests_ queue in batches.
      */
     void runMatchingEngine() noexcept;
 
-    OrderBookMap orderBookForTicker_;
+    /**
+     * @brief Matches a client request, staging its outputs without publishing them.
+     * @param request The client request to process.
+     */
+    void matchClientRequest(const Exchange::OMEClientRequest& request) noexcept;
+
+    /**
+     * @brief Matches the requests queued in rxRequests_, up to MAX_REQUEST_BATCH, and publishes their outputs.
+     * @return False if no request was queued.
+     */
+    bool handleRequestBatch() noexcept;
+
+    const MatchingShard shard_;
+    const std::string threadName_;            ///< Name of the matching thread, outlives it
     Exchange::ClientRequestQueue& rxRequests_;
-    Exchange::ClientResponseQueue& txResponses_;
-    Exchange::MarketUpdateQueue& txMarketUpdates_;
+    QueueSink sink_;                          ///< Stages the messages of the books in the outgoing queues
+    OrderBookMap orderBookForTicker_;         ///< Books of the tickers of the shard, nullptr for the others
+    utils::WaitSignal requestSignal_;         ///< Notified by the producer of rxRequests_ with WaitStrategy::SPIN_PARK
     std::unique_ptr<std::jthread> matchingEngineThread_{nullptr};
     std::atomic<bool> isRunning_{false};
 };
@@ -1,142 +1,203 @@
 #include "order_book.h"
-#include "matching_engine.h"
+#include "lib/assertion.h"
 #include <algorithm>
 #include <format>
+#include <ranges>
+#include <string_view>
 
 namespace MatchingEngine {
 
-OrderBook::OrderBook(Exchange::TickerID assignedTicker, MatchingEngine &ome) noexcept : assignedTicker_(assignedTicker), ome_(ome) {}
+template <OrderBookSink Sink>
+BasicOrderBook<Sink>::BasicOrderBook(Exchange::TickerID assignedTicker, Sink &sink) noexcept : assignedTicker_(assignedTicker), sink_(sink) {}
 
-OrderBook::~OrderBook() {
-    // Log the final state of the order book
-    LOG_INFO("{}\n", toString(false, true));
-    bidsByPrice_ = asksByPrice_ = nullptr;
-    for (auto &oids : mapClientIdToOrder_) {
-        oids.fill(nullptr);
+template <OrderBookSink Sink>
+BasicOrderBook<Sink>::~BasicOrderBook() {
+    // Log the final state of the order book a line at a time, a whole dump would not fit in a log record
+    const auto dump = toString(false, true);
+    for (const auto line : std::views::split(dump, '\n')) {
+        if (!line.empty()) {
+            LOG_INFO("{}", std::string_view(line.begin(), line.end()));
+        }
     }
+    bidsByPrice_ = asksByPrice_ = nullptr;
+    mapClientIdToOrder_.clear();
 }
 
-void OrderBook::addOrder(Exchange::ClientID clientId, Exchange::OrderID clientOid, Exchange::TickerID tickerId, Exchange::Side side,
+template <OrderBookSink Sink>
+void BasicOrderBook<Sink>::addOrder(Exchange::ClientID clientId, Exchange::OrderID clientOid, Exchange::TickerID tickerId, Exchange::Side side,
                          Exchange::Price price, Exchange::Qty qty) noexcept {
     const auto newMarketOid = getNewMarketOrderId();
     clientResponse_ = {Exchange::OMEClientResponse::Type::ACCEPTED, clientId, tickerId, clientOid, newMarketOid, side, price, 0, qty};
-    ome_.dispatchClientResponse(clientResponse_);
+    sink_.onClientResponse(clientResponse_);
 
     const auto qtyRemains = findMatch(clientId, clientOid, tickerId, side, price, qty, newMarketOid);
     if (qtyRemains) [[likely]] {
         const auto priority = getNextPriority(price);
-        auto order = orderPool_.allocate(tickerId, clientId, clientOid, newMarketOid, side, price, qtyRemains, priority, nullptr, nullptr);
+        const auto order = orders_.allocate(tickerId, clientId, clientOid, newMarketOid, side, price, qtyRemains, priority);
+        ASSERT_CONDITION(order != Exchange::OrderIndex_INVALID, "Order store full for ticker: {}", Exchange::tickerIdToStr(tickerId));
         addOrderToBook(order);
 
         marketUpdate_ = {Exchange::OMEMarketUpdate::Type::ADD, newMarketOid, tickerId, side, price, qtyRemains, priority};
-        ome_.publishMarketUpdate(marketUpdate_);
+        sink_.onMarketUpdate(marketUpdate_);
     }
 }
 
-void OrderBook::cancelOrder(Exchange::ClientID clientId, Exchange::OrderID orderId, Exchange::TickerID tickerId) noexcept {
-    bool canBeCanceled = (clientId < mapClientIdToOrder_.size());
-    Exchange::Order *exchangeOrder = nullptr;
+template <OrderBookSink Sink>
+void BasicOrderBook<Sink>::addImmediateOrder(Exchange::ClientID clientId, Exchange::OrderID clientOid, Exchange::TickerID tickerId,
+                                             Exchange::Side side, Exchange::Price price, Exchange::Qty qty, bool isFillOrKill) noexcept {
+    const auto newMarketOid = getNewMarketOrderId();
+    clientResponse_ = {Exchange::OMEClientResponse::Type::ACCEPTED, clientId, tickerId, clientOid, newMarketOid, side, price, 0, qty};
+    sink_.onClientResponse(clientResponse_);
+
+    const auto isFillable = !isFillOrKill || canFill(side, price, qty);
+    const auto qtyRemains = isFillable ? findMatch(clientId, clientOid, tickerId, side, price, qty, newMarketOid) : qty;
+    if (qtyRemains) {
+        // Cancelled before ever resting in the book, so there is no market update
+        clientResponse_ = {Exchange::OMEClientResponse::Type::CANCELLED,
+                           clientId, tickerId,
+                           clientOid, newMarketOid,
+                           side, price,
+                           Exchange::Qty_INVALID, qtyRemains};
+        sink_.onClientResponse(clientResponse_);
+    }
+}
 
-    if (canBeCanceled) [[likely]] {
-        auto &mapClientOrder = mapClientIdToOrder_.at(clientId);
-        exchangeOrder = mapClientOrder.at(orderId);
-        canBeCanceled = (exchangeOrder != nullptr);
+template <OrderBookSink Sink>
+void BasicOrderBook<Sink>::addMarketOrder(Exchange::ClientID clientId, Exchange::OrderID clientOid, Exchange::TickerID tickerId,
+                                          Exchange::Side side, Exchange::Qty qty) noexcept {
+    constexpr auto protection = static_cast<Exchange::Price>(Exchange::Types::MARKET_PROTECTION_TICKS);
+    const auto best = (side == Exchange::Side::BUY) ? asksByPrice_ : bidsByPrice_;
+    auto price = Exchange::Price_INVALID;
+    if (best) [[likely]] {
+        price = (side == Exchange::Side::BUY) ? best->price_ + protection : best->price_ - protection;
     }
+    addImmediateOrder(clientId, clientOid, tickerId, side, price, qty, false);
+}
+
+template <OrderBookSink Sink>
+void BasicOrderBook<Sink>::cancelOrder(Exchange::ClientID clientId, Exchange::OrderID orderId, Exchange::TickerID tickerId) noexcept {
+    const auto clientOrder = mapClientIdToOrder_.find({clientId, orderId});
 
-    if (!canBeCanceled) [[unlikely]] {
+    if (!clientOrder) [[unlikely]] {
         clientResponse_ = {Exchange::OMEClientResponse::Type::CANCEL_REJECTED,
                            clientId, tickerId,
                            orderId,Exchange::OrderID_INVALID, Exchange::Side::INVALID,
                            Exchange::Price_INVALID, Exchange::Qty_INVALID,
                            Exchange::Qty_INVALID};
     } else {
+        const auto exchangeOrder = *clientOrder;
+        const auto &hot = orders_.hot(exchangeOrder);
+        const auto marketOid = orders_.cold(exchangeOrder).marketOrderId_;
+
         clientResponse_ = {Exchange::OMEClientResponse::Type::CANCELLED,
                            clientId, tickerId,
-                           orderId, exchangeOrder->marketOrderId_,
-                           exchangeOrder->side_,exchangeOrder->price_,
-                           Exchange::Qty_INVALID,exchangeOrder->qty_};
+                           orderId, marketOid,
+                           hot.side_, hot.price_,
+                           Exchange::Qty_INVALID, hot.qty_};
 
         marketUpdate_ = {Exchange::OMEMarketUpdate::Type::CANCEL,
-                         exchangeOrder->marketOrderId_, tickerId,
-                         exchangeOrder->side_, exchangeOrder->price_,
-                         0, exchangeOrder->priority_};
+                         marketOid, tickerId,
+                         hot.side_, hot.price_,
+                         0, hot.priority_};
 
         removeOrderFromBook(exchangeOrder);
-        ome_.publishMarketUpdate(marketUpdate_);
+        sink_.onMarketUpdate(marketUpdate_);
     }
-    ome_.dispatchClientResponse(clientResponse_);
+    sink_.onClientResponse(clientResponse_);
 }
 
-Exchange::Qty OrderBook::findMatch(Exchange::ClientID clientId, Exchange::OrderID clientOid,
+template <OrderBookSink Sink>
+Exchange::Qty BasicOrderBook<Sink>::findMatch(Exchange::ClientID clientId, Exchange::OrderID clientOid,
                                    Exchange::TickerID tickerId, Exchange::Side side,
                                    Exchange::Price price, Exchange::Qty qty,
                                    Exchange::OrderID newMarketOid) noexcept {
     auto qtyRemains = qty;
     if (side == Exchange::Side::BUY) {
         while (qtyRemains && asksByPrice_) {
-            const auto asksList = asksByPrice_->order0_;
-            if (price < asksList->price_) [[likely]] {
+            if (price < asksByPrice_->price_) [[likely]] {
                 break;
             }
-            matchOrder(tickerId, clientId, side, clientOid, newMarketOid, asksList, &qtyRemains);
+            matchOrder(tickerId, clientId, side, clientOid, newMarketOid, asksByPrice_->order0_, &qtyRemains);
         }
     } else if (side == Exchange::Side::SELL) {
         while (qtyRemains && bidsByPrice_) {
-            const auto bidsList = bidsByPrice_->order0_;
-            if (price > bidsList->price_) [[likely]] {
+            if (price > bidsByPrice_->price_) [[likely]] {
                 break;
             }
-            matchOrder(tickerId, clientId, side, clientOid, newMarketOid, bidsList, &qtyRemains);
+            matchOrder(tickerId, clientId, side, clientOid, newMarketOid, bidsByPrice_->order0_, &qtyRemains);
         }
     }
     return qtyRemains;
 }
 
-void OrderBook::matchOrder(Exchange::TickerID tickerId, Exchange::ClientID clientId,
+template <OrderBookSink Sink>
+bool BasicOrderBook<Sink>::canFill(Exchange::Side side, Exchange::Price price, Exchange::Qty qty) const noexcept {
+    const auto best = (side == Exchange::Side::BUY) ? asksByPrice_ : bidsByPrice_;
+    Exchange::Qty qtyAvailable = 0;
+    for (auto level = best; level; level = (level->next_ == best) ? nullptr : level->next_) {
+        if ((side == Exchange::Side::BUY && price < level->price_) || (side == Exchange::Side::SELL && price > level->price_)) {
+            break;
+        }
+        for (auto order = level->order0_; ; order = orders_.hot(order).next_) {
+            qtyAvailable += orders_.hot(order).qty_;
+            if (qtyAvailable >= qty) {
+                return true;
+            }
+            if (orders_.hot(order).next_ == level->order0_) break;
+        }
+    }
+    return false;
+}
+
+template <OrderBookSink Sink>
+void BasicOrderBook<Sink>::matchOrder(Exchange::TickerID tickerId, Exchange::ClientID clientId,
                            Exchange::Side side, Exchange::OrderID clientOrderId,
-                           Exchange::OrderID newMarketOid, Exchange::Order *orderMatched,
-                           const Exchange::Qty *qtyRemains) noexcept {
-    const auto fillQty = std::min(*qtyRemains, orderMatched->qty_);
-    qtyRemains -= fillQty;
-    orderMatched->qty_ -= fillQty;
+                           Exchange::OrderID newMarketOid, Exchange::OrderIndex orderMatched,
+                           Exchange::Qty *qtyRemains) noexcept {
+    auto &matched = orders_.hot(orderMatched);
+    const auto &matchedIds = orders_.cold(orderMatched);
+    const auto fillQty = std::min(*qtyRemains, matched.qty_);
+    *qtyRemains -= fillQty;
+    matched.qty_ -= fillQty;
 
     clientResponse_ = { Exchange::OMEClientResponse::Type::FILLED,
                        clientId, tickerId,
                        clientOrderId, newMarketOid,
-                       side, orderMatched->price_,
+                       side, matched.price_,
                        fillQty, *qtyRemains };
-    ome_.dispatchClientResponse(clientResponse_);
+    sink_.onClientResponse(clientResponse_);
 
     clientResponse_ = { Exchange::OMEClientResponse::Type::FILLED,
-                       orderMatched->clientId_,tickerId,
-                       orderMatched->clientOrderId_,orderMatched->marketOrderId_,
-                       orderMatched->side_,orderMatched->price_,
-                       fillQty,orderMatched->qty_ };
-    ome_.dispatchClientResponse(clientResponse_);
+                       matchedIds.clientId_,tickerId,
+                       matchedIds.clientOrderId_,matchedIds.marketOrderId_,
+                       matched.side_,matched.price_,
+                       fillQty,matched.qty_ };
+    sink_.onClientResponse(clientResponse_);
 
     marketUpdate_ = { Exchange::OMEMarketUpdate::Type::TRADE,
                      Exchange::OrderID_INVALID, tickerId,
-                     side, orderMatched->price_,
+                     side, matched.price_,
                      fillQty, Exchange::Priority_INVALID};
-    ome_.publishMarketUpdate(marketUpdate_);
+    sink_.onMarketUpdate(marketUpdate_);
 
-    if (!orderMatched->qty_) {
+    if (!matched.qty_) {
         marketUpdate_ = { Exchange::OMEMarketUpdate::Type::CANCEL,
-                         orderMatched->marketOrderId_, tickerId,
-                         orderMatched->side_,orderMatched->price_,
+                         matchedIds.marketOrderId_, tickerId,
+                         matched.side_,matched.price_,
                          fillQty,Exchange::Priority_INVALID};
-        ome_.publishMarketUpdate(marketUpdate_);
+        sink_.onMarketUpdate(marketUpdate_);
         removeOrderFromBook(orderMatched);
     } else {
         marketUpdate_ = {Exchange::OMEMarketUpdate::Type::MODIFY,
-                         orderMatched->marketOrderId_,tickerId,
-                         orderMatched->side_,orderMatched->price_,
-                         orderMatched->qty_,orderMatched->priority_};
-        ome_.publishMarketUpdate(marketUpdate_);
+                         matchedIds.marketOrderId_,tickerId,
+                         matched.side_,matched.price_,
+                         matched.qty_,matched.priority_};
+        sink_.onMarketUpdate(marketUpdate_);
     }
 }
 
-std::string OrderBook::toString(bool isDetailed, bool hasValidityCheck) const {
+template <OrderBookSink Sink>
+std::string BasicOrderBook<Sink>::toString(bool isDetailed, bool hasValidityCheck) const {
     std::string result;
     result.reserve(4096);  // Pre-allocate space to avoid frequent reallocations
 
@@ -146,10 +207,10 @@ std::string OrderBook::toString(bool isDetailed, bool hasValidityCheck) const {
         size_t orderCount = 0;
 
         // Count orders and total quantity
-        for (auto order = levels->order0_; ; order = order->next_) {
-            totalQty += order->qty_;
+        for (auto order = levels->order0_; ; order = orders_.hot(order).next_) {
+            totalQty += orders_.hot(order).qty_;
             ++orderCount;
-            if (order->next_ == levels->order0_) break;
+            if (orders_.hot(order).next_ == levels->order0_) break;
         }
 
         result += std::format(" {{ p:{:3} [-]:{:3} [+]:{:3} }} {:5} @ {:3} ({:4})\n",
@@ -161,13 +222,14 @@ std::string OrderBook::toString(bool isDetailed, bool hasValidityCheck) const {
                               orderCount);
 
         if (isDetailed) {
-            for (auto order = levels->order0_; ; order = order->next_) {
+            for (auto order = levels->order0_; ; order = orders_.hot(order).next_) {
+                const auto &hot = orders_.hot(order);
                 result += std::format("\t\t\t{{ oid:{}, q:{}, p:{}, n:{} }}\n",
-                                      Exchange::orderIdToStr(order->marketOrderId_),
-                                      Exchange::qtyToStr(order->qty_),
-                                      Exchange::orderIdToStr(order->prev_ ? order->prev_->marketOrderId_ : Exchange::OrderID_INVALID),
-                                      Exchange::orderIdToStr(order->next_ ? order->next_->marketOrderId_ : Exchange::OrderID_INVALID));
-                if (order->next_ == levels->order0_) break;
+                                      Exchange::orderIdToStr(orders_.cold(order).marketOrderId_),
+                                      Exchange::qtyToStr(hot.qty_),
+                                      Exchange::orderIdToStr(orders_.cold(hot.prev_).marketOrderId_),
+                                      Exchange::orderIdToStr(orders_.cold(hot.next_).marketOrderId_));
+                if (hot.next_ == levels->order0_) break;
             }
         }
 
@@ -219,56 +281,100 @@ std::string OrderBook::toString(bool isDetailed, bool hasValidityCheck) const {
     return result;
 }
 
-void OrderBook::addPriceLevel(Exchange::OrdersAtPrice* newOrdersAtPrice) noexcept {
-    // Add new level to hashmap
-    mapPriceToPriceLevel_[priceToIndex(newOrdersAtPrice->price_)] = newOrdersAtPrice;
-
+template <OrderBookSink Sink>
+void BasicOrderBook<Sink>::addPriceLevel(Exchange::OrdersAtPrice* newOrdersAtPrice) noexcept {
     auto& bestOrdersByPrice = (newOrdersAtPrice->side_ == Exchange::Side::BUY) ? bidsByPrice_ : asksByPrice_;
 
     if (!bestOrdersByPrice) [[unlikely]] {
         // Edge case: side of the book is empty
+        priceLevels_.insert(newOrdersAtPrice);
         bestOrdersByPrice = newOrdersAtPrice;
         newOrdersAtPrice->prev_ = newOrdersAtPrice->next_ = newOrdersAtPrice;
-        return;
+    } else {
+        // Find correct insertion point in the doubly-linked list of price levels
+        auto target = findMoreAggressiveLevel(newOrdersAtPrice->side_, newOrdersAtPrice->price_);
+        priceLevels_.insert(newOrdersAtPrice);
+
+        if (target) {
+            // Insert after the closest more aggressive level
+            newOrdersAtPrice->prev_ = target;
+            newOrdersAtPrice->next_ = target->next_;
+            target->next_->prev_ = newOrdersAtPrice;
+            target->next_ = newOrdersAtPrice;
+        } else {
+            // Insert before the current best, this new level becomes the best price
+            target = bestOrdersByPrice;
+            newOrdersAtPrice->next_ = target;
+            newOrdersAtPrice->prev_ = target->prev_;
+            target->prev_->next_ = newOrdersAtPrice;
+            target->prev_ = newOrdersAtPrice;
+            bestOrdersByPrice = newOrdersAtPrice;
+        }
     }
 
-    // Find correct insertion point in the doubly-linked list of price levels
-    auto target = bestOrdersByPrice;
-    bool shouldAddAfter = (newOrdersAtPrice->side_ == Exchange::Side::SELL)
-                              ? (newOrdersAtPrice->price_ > target->price_)
-                              : (newOrdersAtPrice->price_ < target->price_);
-
-    if (shouldAddAfter) {
-        do {
-            target = target->next_;
-            shouldAddAfter = (newOrdersAtPrice->side_ == Exchange::Side::SELL)
-                                 ? (newOrdersAtPrice->price_ > target->price_)
-                                 : (newOrdersAtPrice->price_ < target->price_);
-        } while (shouldAddAfter && target != bestOrdersByPrice);
+    if (!priceLevels_.isInWindow(newOrdersAtPrice->price_)) [[unlikely]] {
+        recenterPriceWindow();
     }
+}
 
-    // Insert new price level
-    if (shouldAddAfter) {
-        // Insert after target
-        newOrdersAtPrice->prev_ = target;
-        newOrdersAtPrice->next_ = target->next_;
-        target->next_->prev_ = newOrdersAtPrice;
-        target->next_ = newOrdersAtPrice;
-    } else {
-        // Insert before target
-        newOrdersAtPrice->next_ = target;
-        newOrdersAtPrice->prev_ = target->prev_;
-        target->prev_->next_ = newOrdersAtPrice;
-        target->prev_ = newOrdersAtPrice;
-
-        // Check if this new level becomes the best price
-        if ((newOrdersAtPrice->side_ == Exchange::Side::BUY && newOrdersAtPrice->price_ > bestOrdersByPrice->price_) ||
-            (newOrdersAtPrice->side_ == Exchange::Side::SELL && newOrdersAtPrice->price_ < bestOrdersByPrice->price_)) {
-            bestOrdersByPrice = newOrdersAtPrice;
+template <OrderBookSink Sink>
+Exchange::OrdersAtPrice* BasicOrderBook<Sink>::findMoreAggressiveLevel(Exchange::Side side, Exchange::Price price) const noexcept {
+    const auto isBuy = (side == Exchange::Side::BUY);
+    const auto isMoreAggressive = [isBuy](Exchange::Price lhs, Exchange::Price rhs) { return isBuy ? lhs > rhs : lhs < rhs; };
+
+    const auto best = isBuy ? bidsByPrice_ : asksByPrice_;
+    if (!isMoreAggressive(best->price_, price)) {
+        return nullptr;
+    }
+
+    // The least aggressive level sits just before the best one in the circular list
+    const auto worst = best->prev_;
+    if (!isMoreAggressive(price, worst->price_)) {
+        return worst;
+    }
+
+    if (priceLevels_.isInWindow(price)) [[likely]] {
+        if (auto level = priceLevels_.findMoreAggressiveInWindow(side, price)) {
+            return level;
         }
+    } else if (isBuy ? price < priceLevels_.getWindowBase() : price > priceLevels_.getWindowBase()) {
+        // Passive outlier: only the outliers beyond it are less aggressive, walk back from the worst level
+        auto target = worst;
+        while (!isMoreAggressive(target->price_, price)) {
+            target = target->prev_;
+        }
+        return target;
+    }
+
+    // Every more aggressive level is an outlier beyond the window, walk them from the best level
+    auto target = best;
+    while (isMoreAggressive(target->next_->price_, price)) {
+        target = target->next_;
     }
+    return target;
 }
-void OrderBook::removePriceLevel(Exchange::Side side, Exchange::Price price) noexcept {
+
+template <OrderBookSink Sink>
+void BasicOrderBook<Sink>::recenterPriceWindow() noexcept {
+    if (!bidsByPrice_ && !asksByPrice_) {
+        return;
+    }
+
+    Exchange::Price mid;
+    if (bidsByPrice_ && asksByPrice_) {
+        mid = bidsByPrice_->price_ + (asksByPrice_->price_ - bidsByPrice_->price_) / 2;
+    } else {
+        mid = bidsByPrice_ ? bidsByPrice_->price_ : asksByPrice_->price_;
+    }
+
+    if (priceLevels_.needsRecenter(mid)) {
+        LOG_INFO("Recentering price window of ticker {} on mid {}", Exchange::tickerIdToStr(assignedTicker_), Exchange::priceToStr(mid));
+        priceLevels_.recenter(mid);
+    }
+}
+
+template <OrderBookSink Sink>
+void BasicOrderBook<Sink>::removePriceLevel(Exchange::Side side, Exchange::Price price) noexcept {
     auto& bestOrdersByPrice = (side == Exchange::Side::BUY) ? bidsByPrice_ : asksByPrice_;
     auto ordersAtPrice = getLevelForPrice(price);
 
@@ -287,55 +393,64 @@ void OrderBook::removePriceLevel(Exchange::Side side, Exchange::Price price) noe
         ordersAtPrice->prev_ = ordersAtPrice->next_ = nullptr;
     }
 
-    // Remove from hashmap and deallocate block in memory pool
-    mapPriceToPriceLevel_[priceToIndex(price)] = nullptr;
+    // Remove from price index and deallocate block in memory pool
+    priceLevels_.erase(side, price);
     ordersAtPricePool_.deallocate(ordersAtPrice);
 }
 
-void OrderBook::addOrderToBook(Exchange::Order* order) noexcept {
+template <OrderBookSink Sink>
+void BasicOrderBook<Sink>::addOrderToBook(Exchange::OrderIndex order) noexcept {
+    auto &hot = orders_.hot(order);
 
-    if (auto priceLevel = getLevelForPrice(order->price_); !priceLevel) {
+    if (auto priceLevel = getLevelForPrice(hot.price_); !priceLevel) {
         // Create a new price level if it doesn't exist
-        order->next_ = order->prev_ = order;
+        hot.next_ = hot.prev_ = order;
         auto newPriceLevel = ordersAtPricePool_.allocate(
-            order->side_, order->price_, order, nullptr, nullptr);
+            hot.side_, hot.price_, order, nullptr, nullptr);
         addPriceLevel(newPriceLevel);
     } else {
         // Append new order to the existing price level
-        auto firstOrder = priceLevel->order0_;
-        order->prev_ = firstOrder->prev_;
-        order->next_ = firstOrder;
-        firstOrder->prev_->next_ = order;
-        firstOrder->prev_ = order;
+        const auto firstOrder = priceLevel->order0_;
+        auto &first = orders_.hot(firstOrder);
+        hot.prev_ = first.prev_;
+        hot.next_ = firstOrder;
+        orders_.hot(first.prev_).next_ = order;
+        first.prev_ = order;
     }
 
     // Add mapping to order hashmap for client ID
-    mapClientIdToOrder_[order->clientId_][order->clientOrderId_] = order;
+    const auto &cold = orders_.cold(order);
+    const auto isIndexed = mapClientIdToOrder_.insert({cold.clientId_, cold.clientOrderId_}, order);
+    ASSERT_CONDITION(isIndexed, "Client order index full, client: {} order: {}",
+                     Exchange::clientIdToStr(cold.clientId_), Exchange::orderIdToStr(cold.clientOrderId_));
 }
-void OrderBook::removeOrderFromBook(Exchange::Order* order) noexcept {
-    auto ordersAtPrice = getLevelForPrice(order->price_);
+template <OrderBookSink Sink>
+void BasicOrderBook<Sink>::removeOrderFromBook(Exchange::OrderIndex order) noexcept {
+    auto &hot = orders_.hot(order);
 
-    if (order->prev_ == order) {
+    if (hot.prev_ == order) {
         // It's the only order at this price level; remove the entire level
-        removePriceLevel(order->side_, order->price_);
+        removePriceLevel(hot.side_, hot.price_);
     } else {
         // Remove the order from the doubly-linked list
-        order->prev_->next_ = order->next_;
-        order->next_->prev_= order->prev_;
+        orders_.hot(hot.prev_).next_ = hot.next_;
+        orders_.hot(hot.next_).prev_ = hot.prev_;
 
-        if (ordersAtPrice->order0_ == order) {
-            ordersAtPrice->order0_ = order->next_;
+        if (auto ordersAtPrice = getLevelForPrice(hot.price_); ordersAtPrice->order0_ == order) {
+            ordersAtPrice->order0_ = hot.next_;
         }
-
-        // Clear the order's links
-        order->prev_ = order->next_ = nullptr;
     }
 
     // Remove from client order map
-    mapClientIdToOrder_[order->clientId_][order->clientOrderId_] = nullptr;
+    const auto &cold = orders_.cold(order);
+    mapClientIdToOrder_.erase({cold.clientId_, cold.clientOrderId_});
 
     // Deallocate the order
-    orderPool_.deallocate(order);
+    orders_.deallocate(order);
 }
 
-} // namespace MatchingEngine
\ No newline at end of file
+template class BasicOrderBook<QueueSink>;
+template class BasicOrderBook<CountingSink>;
+template class BasicOrderBook<VectorSink>;
+
+} // namespace MatchingEngine
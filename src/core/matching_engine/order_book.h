@@ -16,36 +16,45 @@
 #include "../exchange/types.h"
 #include "../exchange/matching_engine_order.h"
 #include "lib/lock_free_queue.h"
+#include "lib/huge_page_allocator.h"
 #include "lib/logger.h"
 #include "lib/memory_pool.h"
 
-namespace MatchingEngine {
+#include "order_book_sink.h"
+#include "price_level_index.h"
 
-class MatchingEngine;
+namespace MatchingEngine {
 
 /**
- * @class OrderBook
+ * @class BasicOrderBook
  * @brief Represents a limit order book for a single financial instrument.
  *
  * This class manages the orders for a specific ticker, handling order additions,
  * cancellations, and matches. It's designed for high-performance in a low-latency
  * trading environment.
+ *
+ * The responses and market updates are delivered to a sink known at compile time, so that
+ * its calls are inlined. The member functions are instantiated in order_book.cpp for the
+ * sinks of order_book_sink.h.
+ *
+ * @tparam Sink Receives the responses and market updates, see OrderBookSink.
  */
-class OrderBook {
+template <OrderBookSink Sink>
+class BasicOrderBook {
   public:
     /**
      * @brief Constructs a limit order book for a single financial instrument/ticker.
      * @param assignedTicker Financial instrument ID
-     * @param ome Reference to the parent Order Matching Engine
+     * @param sink Receives the responses and market updates of the book
      */
-    explicit OrderBook(Exchange::TickerID assignedTicker, MatchingEngine& ome) noexcept;
+    explicit BasicOrderBook(Exchange::TickerID assignedTicker, Sink& sink) noexcept;
 
-    ~OrderBook();
+    ~BasicOrderBook();
 
-    OrderBook(const OrderBook&) = delete;
-    OrderBook& operator=(const OrderBook&) = delete;
-    OrderBook(OrderBook&&) noexcept = delete;
-    OrderBook& operator=(OrderBook&&) noexcept = delete;
+    BasicOrderBook(const BasicOrderBook&) = delete;
+    BasicOrderBook& operator=(const BasicOrderBook&) = delete;
+    BasicOrderBook(BasicOrderBook&&) noexcept = delete;
+    BasicOrderBook& operator=(BasicOrderBook&&) noexcept = delete;
 
     /**
      * @brief Adds a new entry into the limit order book.
@@ -55,6 +64,25 @@ class OrderBook {
     void addOrder(Exchange::ClientID clientId, Exchange::OrderID clientOid, Exchange::TickerID tickerId,
                   Exchange::Side side, Exchange::Price price, Exchange::Qty qty) noexcept;
 
+    /**
+     * @brief Matches an order that never rests in the book, its unfilled quantity is cancelled.
+     * @details An immediate-or-cancel order fills what it can at once. A fill-or-kill order first
+     *          checks, without changing the book, that its whole quantity can be filled, and fills
+     *          nothing otherwise. The remainder gets a CANCELLED response but no order slot, price
+     *          level or market update.
+     * @param isFillOrKill Whether the order is filled in full or not at all.
+     */
+    void addImmediateOrder(Exchange::ClientID clientId, Exchange::OrderID clientOid, Exchange::TickerID tickerId,
+                           Exchange::Side side, Exchange::Price price, Exchange::Qty qty, bool isFillOrKill) noexcept;
+
+    /**
+     * @brief Matches a market order as an immediate-or-cancel order.
+     * @details Its price is protected: it trades at most Types::MARKET_PROTECTION_TICKS past the best
+     *          opposite price. It is cancelled at once if the opposite side is empty.
+     */
+    void addMarketOrder(Exchange::ClientID clientId, Exchange::OrderID clientOid, Exchange::TickerID tickerId,
+                        Exchange::Side side, Exchange::Qty qty) noexcept;
+
     /**
      * @brief Cancels an existing order in the book, if possible.
      */
@@ -70,14 +98,14 @@ class OrderBook {
 
   private:
     Exchange::TickerID assignedTicker_{Exchange::TickerID_INVALID};
-    MatchingEngine& ome_;
+    Sink& sink_;
 
-    Exchange::ClientOrderMap mapClientIdToOrder_{};
+    Exchange::ClientOrderMap mapClientIdToOrder_{Exchange::Types::MAX_ORDER_IDS};
     Exchange::OrdersAtPrice* bidsByPrice_{nullptr};
     Exchange::OrdersAtPrice* asksByPrice_{nullptr};
-    Exchange::OrdersAtPriceMap mapPriceToPriceLevel_{};
-    utils::MemoryPool<Exchange::OrdersAtPrice> ordersAtPricePool_{Exchange::Types::MAX_PRICE_LEVELS};
-    utils::MemoryPool<Exchange::Order> orderPool_{Exchange::Types::MAX_ORDER_IDS};
+    PriceLevelIndex priceLevels_{};
+    utils::MemoryPool<Exchange::OrdersAtPrice, utils::HugePageAllocator<Exchange::OrdersAtPrice>> ordersAtPricePool_{Exchange::Types::MAX_PRICE_LEVELS};
+    Exchange::OrderStore orders_{Exchange::Types::MAX_ORDER_IDS};
 
     Exchange::OMEClientResponse clientResponse_;
     Exchange::OMEMarketUpdate marketUpdate_;
@@ -87,34 +115,59 @@ class OrderBook {
                                           Exchange::TickerID tickerId, Exchange::Side side, Exchange::Price price,
                                           Exchange::Qty qty, Exchange::OrderID newMarketOid) noexcept;
 
+    /**
+     * @brief Checks whether the opposite side holds qty at price or better, without changing the book.
+     */
+    [[nodiscard]] bool canFill(Exchange::Side side, Exchange::Price price, Exchange::Qty qty) const noexcept;
+
     void matchOrder(Exchange::TickerID tickerId, Exchange::ClientID clientId, Exchange::Side side,
                     Exchange::OrderID clientOrderId, Exchange::OrderID newMarketOid,
-                    Exchange::Order* orderMatched, const Exchange::Qty* qtyRemains) noexcept;
+                    Exchange::OrderIndex orderMatched, Exchange::Qty* qtyRemains) noexcept;
 
     [[nodiscard]] inline Exchange::OrderID getNewMarketOrderId() noexcept {
         return nextMarketOid_++;
     }
 
     void addPriceLevel(Exchange::OrdersAtPrice* newOrdersAtPrice) noexcept;
+
+    /**
+     * @brief Finds the closest existing level on a side that is more aggressive than the given price.
+     * @details Prices inside the price window are resolved with a couple of bit scans. Only the
+     *          outlier levels outside the window are walked.
+     * @return The level after which the new price belongs, or nullptr if it becomes the best price.
+     */
+    [[nodiscard]] Exchange::OrdersAtPrice* findMoreAggressiveLevel(Exchange::Side side, Exchange::Price price) const noexcept;
+
     void removePriceLevel(Exchange::Side side, Exchange::Price price) noexcept;
 
     [[nodiscard]] inline Exchange::Priority getNextPriority(Exchange::Price price) const noexcept {
         const auto ordersAtPrice = getLevelForPrice(price);
-        return ordersAtPrice ? ordersAtPrice->order0_->prev_->priority_ + 1ul : 1ul;
-    }
-
-    [[nodiscard]] static constexpr std::size_t priceToIndex(Exchange::Price price) noexcept {
-        return static_cast<std::size_t>(price % Exchange::Types::MAX_PRICE_LEVELS);
+        return ordersAtPrice ? orders_.hot(orders_.hot(ordersAtPrice->order0_).prev_).priority_ + 1ul : 1ul;
     }
 
     [[nodiscard]] inline Exchange::OrdersAtPrice* getLevelForPrice(Exchange::Price price) const noexcept {
-        return mapPriceToPriceLevel_[priceToIndex(price)];
+        return priceLevels_.find(price);
     }
 
-    void addOrderToBook(Exchange::Order* order) noexcept;
-    void removeOrderFromBook( Exchange::Order* order) noexcept;
+    /**
+     * @brief Recenters the price window on the current mid if the market has drifted away from it.
+     */
+    void recenterPriceWindow() noexcept;
+
+    void addOrderToBook(Exchange::OrderIndex order) noexcept;
+    void removeOrderFromBook(Exchange::OrderIndex order) noexcept;
 };
 
+extern template class BasicOrderBook<QueueSink>;
+extern template class BasicOrderBook<CountingSink>;
+extern template class BasicOrderBook<VectorSink>;
+
+/**
+ * @typedef OrderBook
+ * @brief The order book of the matching engine, staging its messages in the outgoing queues
+ */
+using OrderBook = BasicOrderBook<QueueSink>;
+
 /**
  * @typedef OrderBookMap
  * @brief Mapping of tickers to their limit order books
@@ -0,0 +1,177 @@
+//
+// Created by ABDERRAHIM ZEBIRI on 2024-09-15.
+//
+
+#ifndef LOW_LATENCY_TRADING_APP_ORDER_BOOK_SINK_H
+#define LOW_LATENCY_TRADING_APP_ORDER_BOOK_SINK_H
+
+#include <concepts>
+#include <cstddef>
+#include <vector>
+
+#include "../exchange/market_data.h"
+#include "../exchange/order_server_response.h"
+#include "../exchange/request_timing.h"
+#include "lib/logger.h"
+#include "lib/time_utils.h"
+
+/**
+ * @file order_book_sink.h
+ * @brief Where an OrderBook delivers the responses and market updates it generates.
+ *
+ * The book is a template on its sink, so the sink calls are inlined into the add and match
+ * paths instead of crossing into the matching engine.
+ */
+
+namespace MatchingEngine {
+
+/**
+ * @concept OrderBookSink
+ * @brief Receives the responses and market updates of an order book, in generation order.
+ */
+template <typename Sink>
+concept OrderBookSink = requires(Sink& sink, const Exchange::OMEClientResponse& response, const Exchange::OMEMarketUpdate& update) {
+    { sink.onClientResponse(response) } noexcept;
+    { sink.onMarketUpdate(update) } noexcept;
+};
+
+/**
+ * @class QueueSink
+ * @brief Stages the messages in place in the outgoing queues of a matching engine.
+ *
+ * The messages only become visible to their consumers on publish(), so the messages of a batch
+ * of requests cost one index update per queue instead of one per message.
+ */
+class QueueSink {
+  public:
+    /**
+     * @param txResponses Queue for transmitting responses to the order gateway server.
+     * @param txMarketUpdates Queue for pushing market updates to the publisher.
+     */
+    QueueSink(Exchange::ClientResponseQueue& txResponses, Exchange::MarketUpdateQueue& txMarketUpdates) noexcept
+        : txResponses_(txResponses), txMarketUpdates_(txMarketUpdates) {}
+
+    QueueSink(const QueueSink&) = delete;
+    QueueSink& operator=(const QueueSink&) = delete;
+    QueueSink(QueueSink&&) noexcept = delete;
+    QueueSink& operator=(QueueSink&&) noexcept = delete;
+
+    /**
+     * @brief Sets the timestamps of the request being handled, copied into its responses.
+     */
+    auto setTiming(const Exchange::RequestTiming& timing) noexcept -> void {
+        timing_ = timing;
+        timing_.isFirstResponse = true;
+    }
+
+    auto onClientResponse(const Exchange::OMEClientResponse& response) noexcept -> void {
+        LOG_DEBUG("Dispatching client response: {}", response.toStr());
+        if (!stageMessage(txResponses_, nPendingResponses_, Exchange::QueuedClientResponse{response, timing_})) [[unlikely]] {
+            LOG_ERROR("Failed to push client response to queue");
+        }
+        timing_.isFirstResponse = false;
+    }
+
+    auto onMarketUpdate(const Exchange::OMEMarketUpdate& update) noexcept -> void {
+        LOG_DEBUG("Publishing market update: {}", update.toStr());
+        if (!stageMessage(txMarketUpdates_, nPendingMarketUpdates_, update)) [[unlikely]] {
+            LOG_ERROR("Failed to push market update to queue");
+        }
+    }
+
+    /**
+     * @brief Makes the messages staged so far visible to their consumers.
+     * @details Stamps the staged responses with the end of their matching.
+     */
+    auto publish() noexcept -> void {
+        if (nPendingResponses_) {
+            // The responses were staged before the end of the matching of their batch was known
+            const auto tMatchEnd = utils::getCurrentNanos();
+            for (auto& response : txResponses_.claim(nPendingResponses_).first(nPendingResponses_)) {
+                response.timing.tMatchEnd = tMatchEnd;
+            }
+            txResponses_.commit(nPendingResponses_);
+            nPendingResponses_ = 0;
+        }
+        if (nPendingMarketUpdates_) {
+            txMarketUpdates_.commit(nPendingMarketUpdates_);
+            nPendingMarketUpdates_ = 0;
+        }
+    }
+
+  private:
+    /**
+     * @brief Writes a message after the ones already pending in a queue, without publishing it.
+     * @param queue The outgoing queue.
+     * @param nPending The number of messages written but not yet committed to the queue.
+     * @param message The message to write.
+     * @return False if the queue is full.
+     */
+    template <typename Queue, typename Message>
+    auto stageMessage(Queue& queue, std::size_t& nPending, const Message& message) noexcept -> bool {
+        auto slots = queue.claim(nPending + 1);
+        if (slots.size() <= nPending) [[unlikely]] {
+            // The pending batch reaches the end of the ring or fills it: publish it and continue from the start
+            publish();
+            slots = queue.claim(1);
+            if (slots.empty()) [[unlikely]] {
+                return false;
+            }
+        }
+        slots[nPending++] = message;
+        return true;
+    }
+
+    Exchange::ClientResponseQueue& txResponses_;
+    Exchange::MarketUpdateQueue& txMarketUpdates_;
+    std::size_t nPendingResponses_{0};     ///< Responses written to txResponses_ but not yet committed
+    std::size_t nPendingMarketUpdates_{0}; ///< Updates written to txMarketUpdates_ but not yet committed
+    Exchange::RequestTiming timing_{};     ///< Timestamps of the request being handled
+};
+
+/**
+ * @struct CountingSink
+ * @brief Only counts the messages, to benchmark an order book in isolation.
+ */
+struct CountingSink {
+    std::size_t nResponses{0};
+    std::size_t nMarketUpdates{0};
+
+    auto onClientResponse(const Exchange::OMEClientResponse&) noexcept -> void {
+        ++nResponses;
+    }
+
+    auto onMarketUpdate(const Exchange::OMEMarketUpdate&) noexcept -> void {
+        ++nMarketUpdates;
+    }
+};
+
+/**
+ * @struct VectorSink
+ * @brief Keeps a copy of every message, to check them in tests.
+ */
+struct VectorSink {
+    std::vector<Exchange::OMEClientResponse> responses;
+    std::vector<Exchange::OMEMarketUpdate> marketUpdates;
+
+    auto onClientResponse(const Exchange::OMEClientResponse& response) noexcept -> void {
+        responses.push_back(response);
+    }
+
+    auto onMarketUpdate(const Exchange::OMEMarketUpdate& update) noexcept -> void {
+        marketUpdates.push_back(update);
+    }
+
+    auto clear() noexcept -> void {
+        responses.clear();
+        marketUpdates.clear();
+    }
+};
+
+static_assert(OrderBookSink<QueueSink>);
+static_assert(OrderBookSink<CountingSink>);
+static_assert(OrderBookSink<VectorSink>);
+
+} // namespace MatchingEngine
+
+#endif // LOW_LATENCY_TRADING_APP_ORDER_BOOK_SINK_H
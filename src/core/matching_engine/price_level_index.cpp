@@ -0,0 +1,96 @@
+#include "price_level_index.h"
+
+#include "lib/assertion.h"
+
+namespace MatchingEngine {
+
+void PriceLevelIndex::insert(Exchange::OrdersAtPrice* level) noexcept {
+    if (!isInWindow(level->price_) && bidLevels_.empty() && askLevels_.empty()) [[unlikely]] {
+        // Nothing to preserve in the window: move it to where the book actually trades
+        recenter(level->price_);
+    }
+
+    if (isInWindow(level->price_)) [[likely]] {
+        insertInWindow(level);
+    } else {
+        const auto isInserted = overflow_.insert(level->price_, level);
+        ASSERT_CONDITION(isInserted, "Price level overflow table full, price: {}", Exchange::priceToStr(level->price_));
+    }
+}
+
+void PriceLevelIndex::erase(Exchange::Side side, Exchange::Price price) noexcept {
+    if (isInWindow(price)) [[likely]] {
+        window_[slotOf(price)] = nullptr;
+        levelsFor(side).reset(slotOf(price));
+    } else {
+        overflow_.erase(price);
+    }
+}
+
+Exchange::OrdersAtPrice* PriceLevelIndex::findMoreAggressiveInWindow(Exchange::Side side, Exchange::Price price) const noexcept {
+    // Ring slots are ordered by price modulo the window size, so a circular scan starting next to
+    // the price's slot reaches the closest more aggressive level before any less aggressive one.
+    const auto slot = slotOf(price);
+    auto found = LevelBitmap::NPOS;
+    if (side == Exchange::Side::BUY) {
+        found = bidLevels_.findNext(slot + 1);
+        if (found == LevelBitmap::NPOS) {
+            found = bidLevels_.findFirst();
+        }
+    } else {
+        found = slot ? askLevels_.findPrev(slot - 1) : LevelBitmap::NPOS;
+        if (found == LevelBitmap::NPOS) {
+            found = askLevels_.findLast();
+        }
+    }
+
+    if (found == LevelBitmap::NPOS) {
+        return nullptr;
+    }
+    const auto level = window_[found];
+    const auto isMoreAggressive = (side == Exchange::Side::BUY) ? level->price_ > price : level->price_ < price;
+    return isMoreAggressive ? level : nullptr;
+}
+
+void PriceLevelIndex::recenter(Exchange::Price mid) noexcept {
+    const auto newBase = mid - static_cast<Exchange::Price>(WINDOW_TICKS / 2);
+    if (newBase == windowBase_) {
+        return;
+    }
+
+    // Evict the levels falling out of the new window
+    for (auto levels : {&bidLevels_, &askLevels_}) {
+        for (auto slot = levels->findFirst(); slot != LevelBitmap::NPOS; slot = levels->findNext(slot + 1)) {
+            const auto level = window_[slot];
+            if (static_cast<std::uint64_t>(level->price_ - newBase) >= WINDOW_TICKS) {
+                window_[slot] = nullptr;
+                levels->reset(slot);
+                const auto isInserted = overflow_.insert(level->price_, level);
+                ASSERT_CONDITION(isInserted, "Price level overflow table full, price: {}", Exchange::priceToStr(level->price_));
+            }
+        }
+    }
+
+    windowBase_ = newBase;
+
+    // Pull in the overflow levels now covered by the window
+    std::size_t nMigrating = 0;
+    overflow_.forEach([this, &nMigrating](Exchange::Price price, Exchange::OrdersAtPrice* level) {
+        if (isInWindow(price)) {
+            migrating_[nMigrating++] = level;
+        }
+    });
+    for (std::size_t i = 0; i < nMigrating; ++i) {
+        overflow_.erase(migrating_[i]->price_);
+        insertInWindow(migrating_[i]);
+    }
+}
+
+void PriceLevelIndex::insertInWindow(Exchange::OrdersAtPrice* level) noexcept {
+    const auto slot = slotOf(level->price_);
+    ASSERT_CONDITION(window_[slot] == nullptr, "Price window slot {} already holds a level", slot);
+    window_[slot] = level;
+    levelsFor(level->side_).set(slot);
+}
+
+} // namespace MatchingEngine
@@ -0,0 +1,126 @@
+#ifndef LOW_LATENCY_TRADING_APP_PRICE_LEVEL_INDEX_H
+#define LOW_LATENCY_TRADING_APP_PRICE_LEVEL_INDEX_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "../exchange/matching_engine_order.h"
+#include "../exchange/types.h"
+#include "lib/hierarchical_bitmap.h"
+#include "lib/open_addressing_map.h"
+
+namespace MatchingEngine {
+
+/**
+ * @class PriceLevelIndex
+ * @brief Collision-free mapping of prices to the price levels of a single order book.
+ *
+ * Prices inside a window of PRICE_WINDOW_TICKS ticks are stored in a direct-indexed ring
+ * (slot = price modulo the window size). Two prices inside the window always differ by less
+ * than the window size, so they can never share a slot. Prices outside the window are kept in
+ * an open-addressing overflow table. When the market drifts, the window is recentered around
+ * the mid and the levels are migrated between the ring and the overflow table.
+ *
+ * Each side also keeps an occupancy bitmap of its ring slots, so the closest more aggressive
+ * level of a price inside the window is found with a couple of bit scans.
+ */
+class PriceLevelIndex {
+  public:
+    /// Number of ticks covered by the direct-indexed window.
+    static constexpr std::size_t WINDOW_TICKS = Exchange::Types::PRICE_WINDOW_TICKS;
+    static_assert(std::has_single_bit(WINDOW_TICKS), "Price window size must be a power of two.");
+
+    PriceLevelIndex() noexcept : overflow_(Exchange::Types::MAX_PRICE_LEVELS) {}
+
+    PriceLevelIndex(const PriceLevelIndex&) = delete;
+    PriceLevelIndex& operator=(const PriceLevelIndex&) = delete;
+    PriceLevelIndex(PriceLevelIndex&&) noexcept = delete;
+    PriceLevelIndex& operator=(PriceLevelIndex&&) noexcept = delete;
+
+    /**
+     * @brief Checks whether a price falls inside the direct-indexed window.
+     */
+    [[nodiscard]] inline bool isInWindow(Exchange::Price price) const noexcept {
+        return static_cast<std::uint64_t>(price - windowBase_) < WINDOW_TICKS;
+    }
+
+    /**
+     * @brief Returns the lowest price covered by the window.
+     */
+    [[nodiscard]] inline Exchange::Price getWindowBase() const noexcept { return windowBase_; }
+
+    /**
+     * @brief Returns the number of levels currently stored outside the window.
+     */
+    [[nodiscard]] inline std::size_t getOverflowCount() const noexcept { return overflow_.size(); }
+
+    /**
+     * @brief Finds the level for a price.
+     * @return The level, or nullptr if there is no level at this price.
+     */
+    [[nodiscard]] inline Exchange::OrdersAtPrice* find(Exchange::Price price) const noexcept {
+        if (isInWindow(price)) [[likely]] {
+            return window_[slotOf(price)];
+        }
+        const auto level = overflow_.find(price);
+        return level ? *level : nullptr;
+    }
+
+    /**
+     * @brief Adds a new level to the index.
+     * @details Recenters the window on the level if the window holds no level yet.
+     */
+    void insert(Exchange::OrdersAtPrice* level) noexcept;
+
+    /**
+     * @brief Removes the level of a price from the index.
+     */
+    void erase(Exchange::Side side, Exchange::Price price) noexcept;
+
+    /**
+     * @brief Finds the closest level of a side inside the window that is more aggressive than a price.
+     * @pre The price lies inside the window.
+     * @return The level, or nullptr if no more aggressive level of that side is inside the window.
+     */
+    [[nodiscard]] Exchange::OrdersAtPrice* findMoreAggressiveInWindow(Exchange::Side side, Exchange::Price price) const noexcept;
+
+    /**
+     * @brief Checks whether a mid price has drifted out of the central half of the window.
+     */
+    [[nodiscard]] inline bool needsRecenter(Exchange::Price mid) const noexcept {
+        return static_cast<std::uint64_t>(mid - windowBase_ - static_cast<Exchange::Price>(WINDOW_TICKS / 4)) >= WINDOW_TICKS / 2;
+    }
+
+    /**
+     * @brief Moves the window so that it is centered on a mid price.
+     * @details Levels leaving the window are moved to the overflow table and overflow levels
+     *          entering it are moved into the ring. Cost is linear in the number of levels.
+     */
+    void recenter(Exchange::Price mid) noexcept;
+
+  private:
+    using LevelBitmap = utils::HierarchicalBitmap<WINDOW_TICKS>;
+
+    [[nodiscard]] static constexpr std::size_t slotOf(Exchange::Price price) noexcept {
+        return static_cast<std::size_t>(static_cast<std::uint64_t>(price) & (WINDOW_TICKS - 1));
+    }
+
+    [[nodiscard]] inline LevelBitmap& levelsFor(Exchange::Side side) noexcept {
+        return side == Exchange::Side::BUY ? bidLevels_ : askLevels_;
+    }
+
+    void insertInWindow(Exchange::OrdersAtPrice* level) noexcept;
+
+    Exchange::Price windowBase_{0};       ///< Lowest price covered by the window
+    Exchange::OrdersAtPriceMap window_{}; ///< Ring of levels inside the window, indexed by slotOf()
+    LevelBitmap bidLevels_{};             ///< Ring slots holding a bid level
+    LevelBitmap askLevels_{};             ///< Ring slots holding an ask level
+    utils::OpenAddressingMap<Exchange::Price, Exchange::OrdersAtPrice*> overflow_; ///< Levels outside the window
+    std::array<Exchange::OrdersAtPrice*, Exchange::Types::MAX_PRICE_LEVELS> migrating_{}; ///< Scratch space for recenter()
+};
+
+} // namespace MatchingEngine
+
+#endif // LOW_LATENCY_TRADING_APP_PRICE_LEVEL_INDEX_H
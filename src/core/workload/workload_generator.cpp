@@ -0,0 +1,141 @@
+#include "workload_generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "lib/assertion.h"
+
+namespace Workload {
+
+WorkloadGenerator::WorkloadGenerator(WorkloadConfig config)
+    : config_(std::move(config)), rng_(config_.seed), mids_(config_.nTickers, config_.initialMid),
+      liveOrders_(config_.clients.size()), nextOrderIds_(config_.clients.size(), 1) {
+    ASSERT_CONDITION(!config_.clients.empty(), "<WorkloadGenerator> At least one client is needed");
+    ASSERT_CONDITION(config_.nTickers > 0 && config_.nTickers <= Exchange::Types::MAX_TICKERS,
+                     "<WorkloadGenerator> Invalid number of tickers: {}", config_.nTickers);
+    ASSERT_CONDITION(config_.ratePerSecond > 0.0, "<WorkloadGenerator> The arrival rate should be positive");
+
+    double totalWeight = 0.0;
+    for (const auto& client : config_.clients) {
+        ASSERT_CONDITION(client.clientId < Exchange::Types::MAX_N_CLIENTS, "<WorkloadGenerator> Invalid client ID: {}", client.clientId);
+        ASSERT_CONDITION(client.minQty > 0 && client.minQty <= client.maxQty, "<WorkloadGenerator> Invalid quantities for client: {}", client.clientId);
+        totalWeight += client.weight;
+        cumulativeWeights_.push_back(totalWeight);
+    }
+    ASSERT_CONDITION(totalWeight > 0.0, "<WorkloadGenerator> The client weights should not all be 0");
+}
+
+auto WorkloadGenerator::next() -> WorkloadRequest {
+    WorkloadRequest generated{tNext_, {}};
+    tNext_ += nextGap();
+
+    const auto clientIndex = pickClient();
+    const auto& client = config_.clients[clientIndex];
+    auto& liveOrders = liveOrders_[clientIndex];
+    auto& request = generated.request;
+    request.clientId = client.clientId;
+
+    if (!liveOrders.empty() && uniform() < client.cancelProbability) {
+        // Swap-remove a random resting order
+        const auto index = uniformIndex(liveOrders.size());
+        const auto order = liveOrders[index];
+        liveOrders[index] = liveOrders.back();
+        liveOrders.pop_back();
+
+        request.type = Exchange::OMEClientRequest::Type::CANCEL;
+        request.tickerId = order.tickerId;
+        request.orderId = order.orderId;
+        request.side = order.side;
+        request.price = order.price;
+        request.qty = 0;
+    } else {
+        const auto tickerId = static_cast<Exchange::TickerID>(uniformIndex(config_.nTickers));
+        const auto side = uniformIndex(2) ? Exchange::Side::BUY : Exchange::Side::SELL;
+        // Bids below the mid and asks above it, aggressive orders on the other side of it
+        const Exchange::Price sign = side == Exchange::Side::BUY ? -1 : 1;
+        const auto mid = mids_[tickerId];
+        const auto price = uniform() < client.aggressiveProbability
+                               ? mid - sign * static_cast<Exchange::Price>(uniformIndex(static_cast<std::size_t>(client.maxAggressiveTicks) + 1))
+                               : mid + sign * static_cast<Exchange::Price>(1 + geometric(std::max(client.meanPassiveDistance - 1.0, 0.0)));
+
+        request.type = Exchange::OMEClientRequest::Type::NEW;
+        request.tickerId = tickerId;
+        request.orderId = nextOrderIds_[clientIndex]++;
+        request.side = side;
+        request.price = std::max<Exchange::Price>(price, 1);
+        request.qty = nextQty(client);
+        if (liveOrders.size() < MAX_TRACKED_ORDERS_PER_CLIENT) [[likely]] {
+            liveOrders.push_back({tickerId, request.orderId, side, request.price});
+        } else {
+            liveOrders[uniformIndex(liveOrders.size())] = {tickerId, request.orderId, side, request.price};
+        }
+    }
+
+    if (uniform() < config_.midDriftProbability) {
+        auto& mid = mids_[request.tickerId];
+        mid = std::max<Exchange::Price>(mid + (uniformIndex(2) ? 1 : -1), 2);
+    }
+    return generated;
+}
+
+auto WorkloadGenerator::generate(std::size_t nRequests, std::vector<WorkloadRequest>& out) -> void {
+    out.reserve(out.size() + nRequests);
+    for (std::size_t i = 0; i < nRequests; ++i) {
+        out.push_back(next());
+    }
+}
+
+auto WorkloadGenerator::uniform() noexcept -> double {
+    // 53 random bits, the precision of a double, in [0, 1)
+    return static_cast<double>(rng_() >> 11) * 0x1.0p-53;
+}
+
+auto WorkloadGenerator::uniformIndex(std::size_t n) noexcept -> std::size_t {
+    return static_cast<std::size_t>(uniform() * static_cast<double>(n));
+}
+
+auto WorkloadGenerator::geometric(double mean) noexcept -> std::uint64_t {
+    // Number of failures before a success of probability 1 / (mean + 1)
+    if (mean <= 0.0) {
+        return 0;
+    }
+    const auto p = 1.0 / (mean + 1.0);
+    return static_cast<std::uint64_t>(std::floor(std::log1p(-uniform()) / std::log1p(-p)));
+}
+
+auto WorkloadGenerator::nextGap() noexcept -> utils::Nanos {
+    const auto meanGap = static_cast<double>(utils::NANOS_TO_SECS) / config_.ratePerSecond;
+    switch (config_.arrivalProcess) {
+    case ArrivalProcess::CONSTANT: return static_cast<utils::Nanos>(meanGap);
+    case ArrivalProcess::POISSON: return static_cast<utils::Nanos>(-std::log1p(-uniform()) * meanGap);
+    case ArrivalProcess::BURSTY:
+        if (!nLeftInPhase_) {
+            isBursting_ = !isBursting_;
+            nLeftInPhase_ = 1 + geometric((isBursting_ ? config_.meanBurstLength : config_.meanCalmLength) - 1.0);
+        }
+        --nLeftInPhase_;
+        return static_cast<utils::Nanos>(-std::log1p(-uniform()) * (isBursting_ ? meanGap / config_.burstFactor : meanGap));
+    }
+    return static_cast<utils::Nanos>(meanGap);
+}
+
+auto WorkloadGenerator::nextQty(const ClientProfile& client) noexcept -> Exchange::Qty {
+    switch (client.qtyDistribution) {
+    case QtyDistribution::UNIFORM:
+        return client.minQty + static_cast<Exchange::Qty>(uniformIndex(static_cast<std::size_t>(client.maxQty - client.minQty) + 1));
+    case QtyDistribution::GEOMETRIC: {
+        const auto tail = geometric(static_cast<double>(client.meanQty) - static_cast<double>(client.minQty));
+        return static_cast<Exchange::Qty>(std::min<std::uint64_t>(client.minQty + tail, client.maxQty));
+    }
+    }
+    return client.minQty;
+}
+
+auto WorkloadGenerator::pickClient() noexcept -> std::size_t {
+    const auto target = uniform() * cumulativeWeights_.back();
+    const auto it = std::ranges::upper_bound(cumulativeWeights_, target);
+    return std::min(static_cast<std::size_t>(it - cumulativeWeights_.begin()), cumulativeWeights_.size() - 1);
+}
+
+} // namespace Workload
@@ -0,0 +1,154 @@
+#ifndef LOW_LATENCY_TRADING_APP_WORKLOAD_GENERATOR_H
+#define LOW_LATENCY_TRADING_APP_WORKLOAD_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/exchange/order_server_request.h"
+#include "core/exchange/types.h"
+#include "lib/time_utils.h"
+
+/**
+ * @file workload_generator.h
+ * @brief Seeded synthetic order flow for benchmarks and soak tests.
+ */
+
+namespace Workload {
+
+/// @brief Resting orders remembered per client as cancel targets, a random one is forgotten beyond that
+inline constexpr std::size_t MAX_TRACKED_ORDERS_PER_CLIENT = 64 * 1024;
+
+/**
+ * @brief How the arrival times of the requests are spaced.
+ */
+enum class ArrivalProcess : std::uint8_t {
+    CONSTANT, ///< Every 1 / ratePerSecond
+    POISSON,  ///< Exponential gaps with mean 1 / ratePerSecond
+    BURSTY    ///< Poisson, switching between the base rate and burstFactor times it
+};
+
+/**
+ * @brief Distribution of order quantities.
+ */
+enum class QtyDistribution : std::uint8_t {
+    UNIFORM,  ///< Uniform between minQty and maxQty
+    GEOMETRIC ///< minQty plus a geometric tail of mean meanQty - minQty, capped at maxQty: mostly small orders
+};
+
+/**
+ * @struct ClientProfile
+ * @brief Behaviour of one client of the flow.
+ */
+struct ClientProfile {
+    Exchange::ClientID clientId{0};          ///< ID of the client, below Types::MAX_N_CLIENTS
+    double weight{1.0};                      ///< Share of the requests sent by this client, relative to the others
+    double cancelProbability{0.3};           ///< Probability that a request cancels one of its resting orders
+    double aggressiveProbability{0.1};       ///< Probability that a new order crosses the mid
+    double meanPassiveDistance{3.0};         ///< Mean distance of passive orders from the mid, in ticks, geometric
+    Exchange::Price maxAggressiveTicks{3};   ///< Aggressive orders cross the mid by 0 to this many ticks
+    QtyDistribution qtyDistribution{QtyDistribution::GEOMETRIC}; ///< Distribution of the order sizes
+    Exchange::Qty minQty{1};                 ///< Smallest order
+    Exchange::Qty meanQty{20};               ///< Mean order with QtyDistribution::GEOMETRIC
+    Exchange::Qty maxQty{500};               ///< Largest order
+};
+
+/**
+ * @struct WorkloadConfig
+ * @brief Parameters of a generated order flow.
+ */
+struct WorkloadConfig {
+    std::uint64_t seed{1};                              ///< The same seed and config give the same flow
+    std::size_t nTickers{1};                            ///< Tickers 0 to nTickers - 1, chosen uniformly
+    ArrivalProcess arrivalProcess{ArrivalProcess::POISSON}; ///< Spacing of the arrival times
+    double ratePerSecond{100'000.0};                    ///< Mean arrival rate, outside bursts
+    double burstFactor{10.0};                           ///< BURSTY: rate multiplier during bursts
+    double meanBurstLength{1'000.0};                    ///< BURSTY: mean number of requests per burst
+    double meanCalmLength{10'000.0};                    ///< BURSTY: mean number of requests between bursts
+    Exchange::Price initialMid{10'000};                 ///< Mid price of every ticker at the start
+    double midDriftProbability{0.01};                   ///< Probability that the mid of the ticker moves by one tick after a request
+    std::vector<ClientProfile> clients{ClientProfile{}}; ///< Clients sending the flow, at least one
+};
+
+/**
+ * @struct WorkloadRequest
+ * @brief A generated request and the time it arrives.
+ */
+struct WorkloadRequest {
+    utils::Nanos tArrival{0};           ///< Arrival time, relative to the start of the flow
+    Exchange::OMEClientRequest request; ///< The request
+};
+
+/**
+ * @class WorkloadGenerator
+ * @brief Generates a deterministic stream of client requests.
+ *
+ * New orders are bids below or asks above a mid that follows a random walk per ticker, at a
+ * geometric distance from it, except aggressive ones which cross it. Cancels target a random
+ * resting order of the client; the generator does not know which orders were filled, so some
+ * cancels are rejected by the book like late cancels would be. Order IDs are unique per client.
+ *
+ * The random numbers come from std::mt19937_64, whose output the standard specifies, through
+ * the generator's own transforms rather than the std distributions, whose output differs
+ * between standard library implementations.
+ */
+class WorkloadGenerator {
+  public:
+    /**
+     * @brief Constructs a generator, the config is copied.
+     */
+    explicit WorkloadGenerator(WorkloadConfig config);
+
+    WorkloadGenerator(const WorkloadGenerator&) = delete;
+    WorkloadGenerator(WorkloadGenerator&&) = default;
+    WorkloadGenerator& operator=(const WorkloadGenerator&) = delete;
+    WorkloadGenerator& operator=(WorkloadGenerator&&) = default;
+
+    /**
+     * @brief Returns the next request of the flow.
+     */
+    [[nodiscard]] auto next() -> WorkloadRequest;
+
+    /**
+     * @brief Appends the next nRequests requests to a vector.
+     */
+    auto generate(std::size_t nRequests, std::vector<WorkloadRequest>& out) -> void;
+
+    /**
+     * @brief Returns the current mid price of a ticker.
+     */
+    [[nodiscard]] auto getMid(Exchange::TickerID tickerId) const noexcept -> Exchange::Price {
+        return mids_[tickerId];
+    }
+
+  private:
+    /// @brief Order of a client that may still rest in the book
+    struct LiveOrder {
+        Exchange::TickerID tickerId;
+        Exchange::OrderID orderId;
+        Exchange::Side side;
+        Exchange::Price price;
+    };
+
+    [[nodiscard]] auto uniform() noexcept -> double;
+    [[nodiscard]] auto uniformIndex(std::size_t n) noexcept -> std::size_t;
+    [[nodiscard]] auto geometric(double mean) noexcept -> std::uint64_t;
+    [[nodiscard]] auto nextGap() noexcept -> utils::Nanos;
+    [[nodiscard]] auto nextQty(const ClientProfile& client) noexcept -> Exchange::Qty;
+    [[nodiscard]] auto pickClient() noexcept -> std::size_t;
+
+    WorkloadConfig config_;
+    std::mt19937_64 rng_;
+    std::vector<double> cumulativeWeights_;              ///< Of the clients, for pickClient()
+    std::vector<Exchange::Price> mids_;                  ///< Mid price per ticker
+    std::vector<std::vector<LiveOrder>> liveOrders_;     ///< Orders of each client that may rest in the book
+    std::vector<Exchange::OrderID> nextOrderIds_;        ///< Next order ID of each client
+    utils::Nanos tNext_{0};                              ///< Arrival time of the next request
+    std::size_t nLeftInPhase_{0};                        ///< BURSTY: requests left before the phase switches
+    bool isBursting_{false};                             ///< BURSTY: whether the current phase is a burst
+};
+
+} // namespace Workload
+
+#endif // LOW_LATENCY_TRADING_APP_WORKLOAD_GENERATOR_H
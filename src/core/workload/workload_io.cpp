@@ -0,0 +1,113 @@
+#include "workload_io.h"
+
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "lib/time_utils.h"
+
+namespace Workload {
+
+namespace {
+
+/// @brief Requests written per write() call
+constexpr std::size_t WRITE_BATCH = 4096;
+
+auto appendRecord(const WorkloadRequest& request, std::string& out) -> void {
+    out.append(reinterpret_cast<const char*>(&request.tArrival), sizeof(request.tArrival));
+    out.append(reinterpret_cast<const char*>(&request.request), sizeof(request.request));
+}
+
+template <typename NextRequest>
+auto writeRecords(std::string_view path, std::size_t nRequests, NextRequest&& nextRequest) -> bool {
+    std::ofstream file(std::string(path), std::ios::binary | std::ios::trunc);
+    file.write(WORKLOAD_FILE_MAGIC.data(), WORKLOAD_FILE_MAGIC.size());
+    std::string buffer;
+    buffer.reserve(WRITE_BATCH * WORKLOAD_RECORD_SIZE);
+    for (std::size_t i = 0; i < nRequests && file; ++i) {
+        appendRecord(nextRequest(i), buffer);
+        if (buffer.size() == WRITE_BATCH * WORKLOAD_RECORD_SIZE) {
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.close();
+    return !file.fail();
+}
+
+/**
+ * @brief Spins until the request is pushed, stamping it as received and sequenced now.
+ */
+auto pushRequest(Exchange::ClientRequestQueue& queue, const Exchange::OMEClientRequest& request) noexcept -> void {
+    const auto now = utils::getCurrentNanos();
+    while (!queue.push({request, {0, now, now, 0, 0, 0}})) {
+    }
+}
+
+/**
+ * @brief Replays arrival times in real time, from the first one.
+ */
+class Pacer {
+  public:
+    auto waitFor(utils::Nanos tArrival) noexcept -> void {
+        if (!isStarted_) [[unlikely]] {
+            isStarted_ = true;
+            offset_ = utils::getCurrentNanos() - tArrival;
+        }
+        while (utils::getCurrentNanos() < offset_ + tArrival) {
+        }
+    }
+
+  private:
+    bool isStarted_{false};
+    utils::Nanos offset_{0}; ///< Time of arrival 0
+};
+
+} // namespace
+
+auto writeWorkloadFile(std::string_view path, WorkloadGenerator& generator, std::size_t nRequests) -> bool {
+    return writeRecords(path, nRequests, [&generator](std::size_t) { return generator.next(); });
+}
+
+auto writeWorkloadFile(std::string_view path, std::span<const WorkloadRequest> requests) -> bool {
+    return writeRecords(path, requests.size(), [requests](std::size_t i) { return requests[i]; });
+}
+
+auto readWorkloadFile(std::string_view path, std::vector<WorkloadRequest>& out) -> bool {
+    std::ifstream file(std::string(path), std::ios::binary);
+    std::array<char, WORKLOAD_FILE_MAGIC.size()> magic{};
+    if (!file.read(magic.data(), magic.size()) || magic != WORKLOAD_FILE_MAGIC) {
+        return false;
+    }
+    std::array<char, WORKLOAD_RECORD_SIZE> record{};
+    while (file.read(record.data(), record.size())) {
+        auto& request = out.emplace_back();
+        std::memcpy(&request.tArrival, record.data(), sizeof(request.tArrival));
+        std::memcpy(&request.request, record.data() + sizeof(request.tArrival), sizeof(request.request));
+    }
+    return file.eof() && file.gcount() == 0;
+}
+
+auto feedRequestQueue(Exchange::ClientRequestQueue& queue, std::span<const WorkloadRequest> requests, bool isPaced) -> void {
+    Pacer pacer;
+    for (const auto& request : requests) {
+        if (isPaced) {
+            pacer.waitFor(request.tArrival);
+        }
+        pushRequest(queue, request.request);
+    }
+}
+
+auto feedRequestQueue(Exchange::ClientRequestQueue& queue, WorkloadGenerator& generator, std::size_t nRequests, bool isPaced) -> void {
+    Pacer pacer;
+    for (std::size_t i = 0; i < nRequests; ++i) {
+        const auto request = generator.next();
+        if (isPaced) {
+            pacer.waitFor(request.tArrival);
+        }
+        pushRequest(queue, request.request);
+    }
+}
+
+} // namespace Workload
@@ -0,0 +1,64 @@
+#ifndef LOW_LATENCY_TRADING_APP_WORKLOAD_IO_H
+#define LOW_LATENCY_TRADING_APP_WORKLOAD_IO_H
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "core/exchange/order_server_request.h"
+#include "workload_generator.h"
+
+/**
+ * @file workload_io.h
+ * @brief Saving generated order flows to files and feeding them to the matching engine.
+ *
+ * A workload file is the WORKLOAD_FILE_MAGIC bytes followed by one record per request: the
+ * arrival time (8 bytes) and the packed OMEClientRequest, in host byte order.
+ */
+
+namespace Workload {
+
+/// @brief Identifies workload files, the last two characters are the version of the layout
+inline constexpr std::array<char, 8> WORKLOAD_FILE_MAGIC{'H', 'F', 'T', 'W', 'K', 'L', '0', '1'};
+/// @brief Size of a request in a workload file
+inline constexpr std::size_t WORKLOAD_RECORD_SIZE = sizeof(utils::Nanos) + sizeof(Exchange::OMEClientRequest);
+
+/**
+ * @brief Writes the next nRequests requests of a generator to a new workload file.
+ * @return False if the file cannot be written.
+ */
+[[nodiscard]] auto writeWorkloadFile(std::string_view path, WorkloadGenerator& generator, std::size_t nRequests) -> bool;
+
+/**
+ * @brief Writes requests to a new workload file.
+ * @return False if the file cannot be written.
+ */
+[[nodiscard]] auto writeWorkloadFile(std::string_view path, std::span<const WorkloadRequest> requests) -> bool;
+
+/**
+ * @brief Appends the requests of a workload file to a vector.
+ * @return False if the file cannot be read, is not a workload file or ends with a partial record.
+ */
+[[nodiscard]] auto readWorkloadFile(std::string_view path, std::vector<WorkloadRequest>& out) -> bool;
+
+/**
+ * @brief Pushes requests to the matching engine, waiting while the queue is full.
+ * @details The requests bypass the order gateway: their tGatewayRx and tSequenced are the time
+ * they are pushed. Must be the only producer of the queue.
+ * @param queue The request queue of the matching engine.
+ * @param requests The requests to push.
+ * @param isPaced Whether to push each request at its arrival time, counted from the first
+ *                request pushed, rather than as fast as the queue allows.
+ */
+auto feedRequestQueue(Exchange::ClientRequestQueue& queue, std::span<const WorkloadRequest> requests, bool isPaced) -> void;
+
+/**
+ * @brief Pushes the next nRequests requests of a generator to the matching engine, as above.
+ */
+auto feedRequestQueue(Exchange::ClientRequestQueue& queue, WorkloadGenerator& generator, std::size_t nRequests, bool isPaced) -> void;
+
+} // namespace Workload
+
+#endif // LOW_LATENCY_TRADING_APP_WORKLOAD_IO_H
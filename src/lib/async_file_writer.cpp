@@ -0,0 +1,336 @@
+#include "async_file_writer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "assertion.h"
+#include "thread_utils.h"
+#include "time_utils.h"
+
+namespace utils {
+
+namespace {
+
+/**
+ * @brief Turns direct I/O off for a file, for writes that are not block aligned.
+ */
+auto disableDirectIO([[maybe_unused]] int fd) noexcept -> void {
+#ifdef O_DIRECT
+    const auto flags = fcntl(fd, F_GETFL);
+    if (flags >= 0 && (flags & O_DIRECT)) {
+        fcntl(fd, F_SETFL, flags & ~O_DIRECT);
+    }
+#endif
+}
+
+} // namespace
+
+auto AsyncFileWriter::AlignedFree::operator()(char* buffer) const noexcept -> void {
+    std::free(buffer);
+}
+
+AsyncFileWriter::AsyncFileWriter() {
+    for (auto& buffer : buffers_) {
+        buffer.reset(static_cast<char*>(std::aligned_alloc(FILE_WRITER_BLOCK_SIZE, FILE_WRITER_BUFFER_SIZE)));
+        ASSERT_CONDITION(buffer != nullptr, "Failed to allocate {} bytes file writer buffer", FILE_WRITER_BUFFER_SIZE);
+    }
+#ifdef HFT_HAS_LIBURING
+    hasRing_ = io_uring_queue_init(8, &ring_, 0) == 0;
+#endif
+    ioThread_ = createAndStartThread(-1, "log writer", [this] { run(); });
+    ASSERT_CONDITION(ioThread_ != nullptr, "Failed to create file writer thread");
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    close();
+    {
+        std::scoped_lock lock(mutex_);
+        isStopping_ = true;
+    }
+    hasWork_.notify_one();
+    if (ioThread_ && ioThread_->joinable()) {
+        ioThread_->join();
+    }
+#ifdef HFT_HAS_LIBURING
+    if (hasRing_) {
+        io_uring_queue_exit(&ring_);
+    }
+#endif
+}
+
+auto AsyncFileWriter::open(std::string_view path, const FileWriterOptions& options) -> bool {
+    auto file = openFile(std::string(path), options);
+    if (!file) {
+        return false;
+    }
+    isDirectIO_.store(options.useDirectIO, std::memory_order_relaxed);
+    submit({Command::Type::SWITCH_FILE, 0, 0, false, std::move(file)});
+    return true;
+}
+
+auto AsyncFileWriter::append(std::string_view data) -> void {
+    while (!data.empty()) {
+        const auto nBytes = std::min(data.size(), FILE_WRITER_BUFFER_SIZE - frontSize_);
+        std::memcpy(buffers_[front_].get() + frontSize_, data.data(), nBytes);
+        frontSize_ += nBytes;
+        data.remove_prefix(nBytes);
+        if (frontSize_ == FILE_WRITER_BUFFER_SIZE) {
+            submitFront(false);
+        }
+    }
+}
+
+auto AsyncFileWriter::flush() -> void {
+    if (frontSize_) {
+        submitFront(false);
+    }
+}
+
+auto AsyncFileWriter::sync() -> void {
+    std::unique_lock lock(mutex_);
+    isIdle_.wait(lock, [this] { return commands_.empty() && !nInFlight_; });
+}
+
+auto AsyncFileWriter::close() -> void {
+    submitFront(true);
+    submit({Command::Type::CLOSE_FILE, 0, 0, false, nullptr});
+    sync();
+}
+
+auto AsyncFileWriter::openFile(const std::string& path, const FileWriterOptions& options) -> std::shared_ptr<OpenFile> {
+    auto flags = O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC;
+#ifdef O_DIRECT
+    if (options.useDirectIO) {
+        flags |= O_DIRECT;
+    }
+#endif
+    auto fd = ::open(path.c_str(), flags, 0644);
+#ifdef O_DIRECT
+    if (fd < 0 && options.useDirectIO && errno == EINVAL) {
+        // File system without direct I/O support
+        fd = ::open(path.c_str(), flags & ~O_DIRECT, 0644);
+    }
+#endif
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat fileStat {};
+    fstat(fd, &fileStat);
+    const auto size = static_cast<std::size_t>(fileStat.st_size);
+#ifdef __linux__
+    if (options.preallocateBytes) {
+        // Best effort: reserve the blocks without changing the visible file size
+        fallocate(fd, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(size), static_cast<off_t>(options.preallocateBytes));
+    }
+#endif
+    return std::make_shared<OpenFile>(OpenFile{fd, path, options, size, std::chrono::steady_clock::now()});
+}
+
+auto AsyncFileWriter::closeFile(OpenFile& file) noexcept -> void {
+    if (file.fd >= 0) {
+        ::close(file.fd);
+        file.fd = -1;
+    }
+}
+
+auto AsyncFileWriter::submit(Command command) -> void {
+    {
+        std::scoped_lock lock(mutex_);
+        commands_.push_back(std::move(command));
+    }
+    hasWork_.notify_one();
+}
+
+auto AsyncFileWriter::submitFront(bool isFinal) -> void {
+    // In direct I/O mode only whole blocks are written, except for the final write
+    const auto isDirect = isDirectIO_.load(std::memory_order_relaxed) && !isFinal;
+    const auto nBytes = isDirect ? frontSize_ & ~(FILE_WRITER_BLOCK_SIZE - 1) : frontSize_;
+    if (!nBytes) {
+        return;
+    }
+
+    const auto next = 1 - front_;
+    {
+        std::unique_lock lock(mutex_);
+        isIdle_.wait(lock, [this, next] { return !isBufferBusy_[next]; });
+        isBufferBusy_[front_] = true;
+        commands_.push_back({Command::Type::WRITE, front_, nBytes, nBytes % FILE_WRITER_BLOCK_SIZE != 0, nullptr});
+    }
+    hasWork_.notify_one();
+
+    // Carry the partial block over, the I/O thread only reads the first nBytes of the buffer
+    const auto nTail = frontSize_ - nBytes;
+    std::memcpy(buffers_[next].get(), buffers_[front_].get() + nBytes, nTail);
+    front_ = next;
+    frontSize_ = nTail;
+}
+
+auto AsyncFileWriter::run() noexcept -> void {
+    std::vector<Command> batch;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            hasWork_.wait(lock, [this] { return !commands_.empty() || isStopping_; });
+            if (commands_.empty()) {
+                return;
+            }
+            batch.assign(std::make_move_iterator(commands_.begin()), std::make_move_iterator(commands_.end()));
+            commands_.clear();
+            nInFlight_ = batch.size();
+        }
+
+        for (std::size_t i = 0; i < batch.size();) {
+            switch (batch[i].type) {
+            case Command::Type::WRITE: {
+                // Write consecutive buffers with a single call
+                auto nWrites = std::size_t{1};
+                while (i + nWrites < batch.size() && batch[i + nWrites].type == Command::Type::WRITE) {
+                    ++nWrites;
+                }
+                writeBuffers(&batch[i], nWrites);
+                i += nWrites;
+                continue;
+            }
+            case Command::Type::SWITCH_FILE:
+                if (file_) {
+                    closeFile(*file_);
+                }
+                file_ = std::move(batch[i].file);
+                break;
+            case Command::Type::CLOSE_FILE:
+                if (file_) {
+                    closeFile(*file_);
+                    file_.reset();
+                }
+                break;
+            }
+            ++i;
+        }
+
+        {
+            std::scoped_lock lock(mutex_);
+            for (const auto& command : batch) {
+                if (command.type == Command::Type::WRITE) {
+                    isBufferBusy_[command.bufferIndex] = false;
+                }
+            }
+            nInFlight_ = 0;
+        }
+        isIdle_.notify_all();
+    }
+}
+
+auto AsyncFileWriter::writeBuffers(const Command* commands, std::size_t nCommands) noexcept -> void {
+    if (!file_) [[unlikely]] {
+        return;
+    }
+
+    std::array<iovec, std::tuple_size_v<decltype(buffers_)>> iov{};
+    std::size_t nBytes = 0;
+    bool isUnaligned = false;
+    for (std::size_t i = 0; i < nCommands; ++i) {
+        iov[i] = {buffers_[commands[i].bufferIndex].get(), commands[i].size};
+        nBytes += commands[i].size;
+        isUnaligned |= commands[i].isUnaligned;
+    }
+
+    rotateIfNeeded(nBytes);
+    if (!file_) [[unlikely]] {
+        return;
+    }
+    if (isUnaligned && file_->options.useDirectIO) {
+        disableDirectIO(file_->fd);
+    }
+    if (writeAll(iov.data(), nCommands)) [[likely]] {
+        file_->size += nBytes;
+    }
+}
+
+auto AsyncFileWriter::writeAll(iovec* iov, std::size_t nIov) noexcept -> bool {
+    while (nIov) {
+        ssize_t nWritten = -1;
+#ifdef HFT_HAS_LIBURING
+        if (hasRing_) {
+            auto* sqe = io_uring_get_sqe(&ring_);
+            // An offset of -1 writes at the current file position
+            io_uring_prep_writev(sqe, file_->fd, iov, static_cast<unsigned>(nIov), static_cast<__u64>(-1));
+            io_uring_submit(&ring_);
+            io_uring_cqe* cqe = nullptr;
+            const auto waitResult = io_uring_wait_cqe(&ring_, &cqe);
+            if (waitResult < 0) {
+                errno = -waitResult;
+            } else {
+                nWritten = cqe->res;
+                if (nWritten < 0) {
+                    errno = static_cast<int>(-nWritten);
+                    nWritten = -1;
+                }
+                io_uring_cqe_seen(&ring_, cqe);
+            }
+        } else
+#endif
+        {
+            nWritten = ::writev(file_->fd, iov, static_cast<int>(nIov));
+        }
+
+        if (nWritten < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EINVAL && file_->options.useDirectIO) {
+                // Unaligned end of an existing file: fall back to buffered writes for this file
+                disableDirectIO(file_->fd);
+                file_->options.useDirectIO = false;
+                continue;
+            }
+            std::cerr << "Failed to write to " << file_->path << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+        // Skip what was written, in case of a short write
+        auto nLeft = static_cast<std::size_t>(nWritten);
+        while (nIov && nLeft >= iov->iov_len) {
+            nLeft -= iov->iov_len;
+            ++iov;
+            --nIov;
+        }
+        if (nIov) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + nLeft;
+            iov->iov_len -= nLeft;
+        }
+    }
+    return true;
+}
+
+auto AsyncFileWriter::rotateIfNeeded(std::size_t nBytes) noexcept -> void {
+    const auto& options = file_->options;
+    const auto isTooBig = options.rotateAfterBytes && file_->size + nBytes > options.rotateAfterBytes;
+    const auto isTooOld = options.rotateAfter.count() && std::chrono::steady_clock::now() - file_->openedAt >= options.rotateAfter;
+    if (!file_->size || (!isTooBig && !isTooOld)) {
+        return;
+    }
+
+    closeFile(*file_);
+    const auto rotatedPath = file_->path + "." + std::to_string(getCurrentNanos());
+    if (std::rename(file_->path.c_str(), rotatedPath.c_str()) != 0) {
+        std::cerr << "Failed to rotate " << file_->path << ": " << std::strerror(errno) << std::endl;
+    }
+
+    auto next = openFile(file_->path, options);
+    if (!next) {
+        std::cerr << "Failed to reopen " << file_->path << " after rotation" << std::endl;
+    }
+    file_ = std::move(next);
+}
+
+} // namespace utils
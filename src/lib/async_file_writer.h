@@ -0,0 +1,154 @@
+#ifndef LOW_LATENCY_TRADING_APP_ASYNC_FILE_WRITER_H
+#define LOW_LATENCY_TRADING_APP_ASYNC_FILE_WRITER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <sys/uio.h>
+
+#ifdef HFT_HAS_LIBURING
+#include <liburing.h>
+#endif
+
+namespace utils {
+
+/// @brief Size of each of the two buffers of an AsyncFileWriter
+inline constexpr std::size_t FILE_WRITER_BUFFER_SIZE = 1024 * 1024;
+/// @brief Alignment of the buffers, file offsets and write sizes in direct I/O mode
+inline constexpr std::size_t FILE_WRITER_BLOCK_SIZE = 4096;
+
+/**
+ * @struct FileWriterOptions
+ * @brief How an AsyncFileWriter opens, grows and rotates its file.
+ */
+struct FileWriterOptions {
+    std::size_t preallocateBytes{0};          ///< Disk space reserved with fallocate() on open, 0 to disable
+    bool useDirectIO{false};                  ///< Open with O_DIRECT to bypass the page cache
+    std::size_t rotateAfterBytes{0};          ///< Rotate once the file would grow past this size, 0 to disable
+    std::chrono::seconds rotateAfter{0};      ///< Rotate once the file is this old, 0 to disable
+};
+
+/**
+ * @class AsyncFileWriter
+ * @brief Double-buffered append-only file writer with a dedicated I/O thread.
+ *
+ * The producer copies data into the front buffer with append() and hands it over with flush().
+ * The I/O thread writes submitted buffers with a single writev() (or an io_uring writev when
+ * built with HFT_HAS_LIBURING) while the producer fills the other buffer, so the producer only
+ * waits when it fills a buffer before the previous one reached the file.
+ *
+ * Rotation happens on the I/O thread: the current file is renamed to "<path>.<nanoseconds since
+ * epoch>" and a new file is opened at the original path. In direct I/O mode only whole blocks are written, the
+ * last partial block stays in the front buffer until more data or close() completes it; a line
+ * can therefore be split across two rotated files.
+ *
+ * append() and flush() must be called from a single thread at a time; open() and sync() may be
+ * called from any thread.
+ */
+class AsyncFileWriter {
+  public:
+    AsyncFileWriter();
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter(AsyncFileWriter&&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(AsyncFileWriter&&) = delete;
+
+    /**
+     * @brief Opens a file for appending. The file is opened synchronously, data submitted before
+     * the call is still written to the previous file.
+     * @return False if the file cannot be opened.
+     */
+    [[nodiscard]] auto open(std::string_view path, const FileWriterOptions& options = {}) -> bool;
+
+    /**
+     * @brief Copies data into the front buffer, submitting full buffers to the I/O thread.
+     */
+    auto append(std::string_view data) -> void;
+
+    /**
+     * @brief Submits the data appended so far to the I/O thread without waiting for it.
+     */
+    auto flush() -> void;
+
+    /**
+     * @brief Waits until everything submitted so far is written.
+     */
+    auto sync() -> void;
+
+    /**
+     * @brief Writes all pending data, including a partial direct I/O block, and closes the file.
+     */
+    auto close() -> void;
+
+  private:
+    /// @brief File opened for appending, owned by the I/O thread once submitted
+    struct OpenFile {
+        int fd{-1};                             ///< File descriptor
+        std::string path;                       ///< Path the file was opened at
+        FileWriterOptions options;              ///< Options the file was opened with
+        std::size_t size{0};                    ///< Current size of the file
+        std::chrono::steady_clock::time_point openedAt; ///< Time the file was opened
+    };
+
+    /// @brief Work item for the I/O thread
+    struct Command {
+        enum class Type : std::uint8_t { WRITE, SWITCH_FILE, CLOSE_FILE };
+
+        Type type{Type::WRITE};
+        std::size_t bufferIndex{0};           ///< WRITE: buffer to write
+        std::size_t size{0};                  ///< WRITE: number of bytes to write
+        bool isUnaligned{false};              ///< WRITE: size may not be a multiple of the block size
+        std::shared_ptr<OpenFile> file;       ///< SWITCH_FILE: file to write to from now on
+    };
+
+    /// @brief Deleter for the aligned buffers
+    struct AlignedFree {
+        auto operator()(char* buffer) const noexcept -> void;
+    };
+
+    [[nodiscard]] static auto openFile(const std::string& path, const FileWriterOptions& options) -> std::shared_ptr<OpenFile>;
+    static auto closeFile(OpenFile& file) noexcept -> void;
+
+    auto submit(Command command) -> void;
+    auto submitFront(bool isFinal) -> void;
+    auto run() noexcept -> void;
+    auto writeBuffers(const Command* commands, std::size_t nCommands) noexcept -> void;
+    auto writeAll(iovec* iov, std::size_t nIov) noexcept -> bool;
+    auto rotateIfNeeded(std::size_t nBytes) noexcept -> void;
+
+    std::array<std::unique_ptr<char[], AlignedFree>, 2> buffers_; ///< Double buffer
+    std::array<bool, 2> isBufferBusy_{};   ///< Whether a buffer is waiting for or under I/O, guarded by mutex_
+    std::size_t front_{0};                 ///< Buffer filled by append(), producer-owned
+    std::size_t frontSize_{0};             ///< Bytes used in the front buffer, producer-owned
+    std::atomic<bool> isDirectIO_{false};  ///< Whether the last opened file uses direct I/O
+
+    std::mutex mutex_;                     ///< Guards the command queue and the busy flags
+    std::condition_variable hasWork_;      ///< Signals commands to the I/O thread
+    std::condition_variable isIdle_;       ///< Signals buffers released by the I/O thread
+    std::deque<Command> commands_;         ///< Commands waiting for the I/O thread
+    std::size_t nInFlight_{0};             ///< Commands taken by the I/O thread but not completed
+    bool isStopping_{false};               ///< Asks the I/O thread to exit once idle
+
+    std::shared_ptr<OpenFile> file_;       ///< File written by the I/O thread, I/O thread-owned
+#ifdef HFT_HAS_LIBURING
+    io_uring ring_{};                      ///< Submission ring of the I/O thread
+    bool hasRing_{false};                  ///< Whether ring_ was set up
+#endif
+    std::unique_ptr<std::jthread> ioThread_; ///< The I/O thread
+};
+
+} // namespace utils
+
+#endif // LOW_LATENCY_TRADING_APP_ASYNC_FILE_WRITER_H
@@ -0,0 +1,193 @@
+#ifndef LOW_LATENCY_TRADING_APP_HIERARCHICAL_BITMAP_H
+#define LOW_LATENCY_TRADING_APP_HIERARCHICAL_BITMAP_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "assertion.h"
+
+namespace utils {
+
+/**
+ * @class HierarchicalBitmap
+ * @brief A fixed-size occupancy bitmap with constant-time "next/previous set bit" queries.
+ *
+ * Bits are stored in three levels of 64-bit words: the leaf level holds one bit per slot,
+ * the middle level one bit per non-empty leaf word and the top word one bit per non-empty
+ * middle word. Every query therefore resolves with at most three bit scans, regardless of
+ * how sparse the bitmap is.
+ *
+ * @tparam Bits The number of slots tracked by the bitmap (at most 64^3).
+ */
+template <std::size_t Bits>
+class HierarchicalBitmap {
+    static constexpr std::size_t WORD_BITS = 64;
+    static constexpr std::size_t LEAF_WORDS = (Bits + WORD_BITS - 1) / WORD_BITS;
+    static constexpr std::size_t MID_WORDS = (LEAF_WORDS + WORD_BITS - 1) / WORD_BITS;
+
+    static_assert(Bits > 0, "HierarchicalBitmap requires at least one slot.");
+    static_assert(MID_WORDS <= WORD_BITS, "HierarchicalBitmap supports at most 64^3 slots.");
+
+  public:
+    /// Value returned by the search functions when no set bit is found.
+    static constexpr std::size_t NPOS = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * @brief Returns the number of slots tracked by the bitmap.
+     */
+    [[nodiscard]] static constexpr auto size() noexcept -> std::size_t { return Bits; }
+
+    /**
+     * @brief Marks a slot as occupied.
+     * @param index The slot to set.
+     */
+    auto set(std::size_t index) noexcept -> void {
+        ASSERT_CONDITION(index < Bits, "Bitmap index {} out of range.", index);
+        const auto leaf = index / WORD_BITS;
+        leaves_[leaf] |= bit(index);
+        mid_[leaf / WORD_BITS] |= bit(leaf);
+        top_ |= bit(leaf / WORD_BITS);
+    }
+
+    /**
+     * @brief Marks a slot as free.
+     * @param index The slot to clear.
+     */
+    auto reset(std::size_t index) noexcept -> void {
+        ASSERT_CONDITION(index < Bits, "Bitmap index {} out of range.", index);
+        const auto leaf = index / WORD_BITS;
+        leaves_[leaf] &= ~bit(index);
+        if (leaves_[leaf] == 0) {
+            mid_[leaf / WORD_BITS] &= ~bit(leaf);
+            if (mid_[leaf / WORD_BITS] == 0) {
+                top_ &= ~bit(leaf / WORD_BITS);
+            }
+        }
+    }
+
+    /**
+     * @brief Checks whether a slot is occupied.
+     * @param index The slot to check.
+     * @return True if the slot is set.
+     */
+    [[nodiscard]] auto test(std::size_t index) const noexcept -> bool {
+        return index < Bits && (leaves_[index / WORD_BITS] & bit(index)) != 0;
+    }
+
+    /**
+     * @brief Checks whether no slot is occupied.
+     */
+    [[nodiscard]] auto empty() const noexcept -> bool { return top_ == 0; }
+
+    /**
+     * @brief Finds the first set slot at or after the given index.
+     * @param from The index to start searching from.
+     * @return The index of the set slot, or NPOS if there is none.
+     */
+    [[nodiscard]] auto findNext(std::size_t from) const noexcept -> std::size_t {
+        if (from >= Bits) [[unlikely]] {
+            return NPOS;
+        }
+
+        const auto leaf = from / WORD_BITS;
+        if (const auto word = leaves_[leaf] & maskFrom(from % WORD_BITS)) {
+            return leaf * WORD_BITS + std::countr_zero(word);
+        }
+
+        const auto mid = leaf / WORD_BITS;
+        if (const auto nextLeaf = leaf % WORD_BITS + 1; nextLeaf < WORD_BITS) {
+            if (const auto word = mid_[mid] & maskFrom(nextLeaf)) {
+                return lowestInLeaf(mid * WORD_BITS + std::countr_zero(word));
+            }
+        }
+
+        if (const auto nextMid = mid + 1; nextMid < WORD_BITS) {
+            if (const auto word = top_ & maskFrom(nextMid)) {
+                const auto foundMid = static_cast<std::size_t>(std::countr_zero(word));
+                return lowestInLeaf(foundMid * WORD_BITS + std::countr_zero(mid_[foundMid]));
+            }
+        }
+        return NPOS;
+    }
+
+    /**
+     * @brief Finds the last set slot at or before the given index.
+     * @param from The index to start searching from (clamped to the last slot).
+     * @return The index of the set slot, or NPOS if there is none.
+     */
+    [[nodiscard]] auto findPrev(std::size_t from) const noexcept -> std::size_t {
+        if (from >= Bits) {
+            from = Bits - 1;
+        }
+
+        const auto leaf = from / WORD_BITS;
+        if (const auto word = leaves_[leaf] & maskUpTo(from % WORD_BITS)) {
+            return leaf * WORD_BITS + highestBit(word);
+        }
+
+        const auto mid = leaf / WORD_BITS;
+        if (const auto prevLeaf = leaf % WORD_BITS; prevLeaf > 0) {
+            if (const auto word = mid_[mid] & maskUpTo(prevLeaf - 1)) {
+                return highestInLeaf(mid * WORD_BITS + highestBit(word));
+            }
+        }
+
+        if (mid > 0) {
+            if (const auto word = top_ & maskUpTo(mid - 1)) {
+                const auto foundMid = highestBit(word);
+                return highestInLeaf(foundMid * WORD_BITS + highestBit(mid_[foundMid]));
+            }
+        }
+        return NPOS;
+    }
+
+    /**
+     * @brief Finds the lowest set slot.
+     * @return The index of the set slot, or NPOS if the bitmap is empty.
+     */
+    [[nodiscard]] auto findFirst() const noexcept -> std::size_t { return findNext(0); }
+
+    /**
+     * @brief Finds the highest set slot.
+     * @return The index of the set slot, or NPOS if the bitmap is empty.
+     */
+    [[nodiscard]] auto findLast() const noexcept -> std::size_t { return findPrev(Bits - 1); }
+
+  private:
+    [[nodiscard]] static constexpr auto bit(std::size_t index) noexcept -> std::uint64_t {
+        return std::uint64_t{1} << (index % WORD_BITS);
+    }
+
+    /// Mask of all bits at or above the given position.
+    [[nodiscard]] static constexpr auto maskFrom(std::size_t pos) noexcept -> std::uint64_t {
+        return ~std::uint64_t{0} << pos;
+    }
+
+    /// Mask of all bits at or below the given position.
+    [[nodiscard]] static constexpr auto maskUpTo(std::size_t pos) noexcept -> std::uint64_t {
+        return ~std::uint64_t{0} >> (WORD_BITS - 1 - pos);
+    }
+
+    [[nodiscard]] static constexpr auto highestBit(std::uint64_t word) noexcept -> std::size_t {
+        return WORD_BITS - 1 - static_cast<std::size_t>(std::countl_zero(word));
+    }
+
+    [[nodiscard]] auto lowestInLeaf(std::size_t leaf) const noexcept -> std::size_t {
+        return leaf * WORD_BITS + std::countr_zero(leaves_[leaf]);
+    }
+
+    [[nodiscard]] auto highestInLeaf(std::size_t leaf) const noexcept -> std::size_t {
+        return leaf * WORD_BITS + highestBit(leaves_[leaf]);
+    }
+
+    std::array<std::uint64_t, LEAF_WORDS> leaves_{}; ///< One bit per slot.
+    std::array<std::uint64_t, MID_WORDS> mid_{};     ///< One bit per non-empty leaf word.
+    std::uint64_t top_{0};                           ///< One bit per non-empty middle word.
+};
+
+} // namespace utils
+
+#endif // LOW_LATENCY_TRADING_APP_HIERARCHICAL_BITMAP_H
@@ -0,0 +1,136 @@
+#ifndef LOW_LATENCY_TRADING_APP_HUGE_PAGE_ALLOCATOR_H
+#define LOW_LATENCY_TRADING_APP_HUGE_PAGE_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace utils {
+
+/// @brief Size of a huge page on x86-64 and aarch64 Linux, mappings are rounded up to a multiple of it
+inline constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+/**
+ * @brief Maps a prefaulted, locked anonymous region, backed by huge pages when the system allows it.
+ *
+ * Tries an explicit MAP_HUGETLB mapping first, then falls back to a HUGE_PAGE_SIZE aligned
+ * mapping of regular pages with a transparent huge page hint given before any page is faulted
+ * in. Every page is faulted in before returning, so the first write on a latency-critical
+ * thread never traps into the kernel, and the region is mlock()ed on a best effort basis so it
+ * cannot be swapped out (this fails silently above RLIMIT_MEMLOCK).
+ *
+ * @param bytes Size of the region, rounded up to a multiple of HUGE_PAGE_SIZE.
+ * @return The start of the region, or nullptr if it could not be mapped at all.
+ */
+[[nodiscard]] inline auto mapHugePages(std::size_t bytes) noexcept -> void* {
+    void* region = MAP_FAILED;
+#ifdef __linux__
+    region = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+#endif
+    if (region == MAP_FAILED) {
+        // No reserved huge pages: use regular pages and let the kernel promote them. Over-map by a
+        // huge page to align the start, and fault nothing in before the hint, or the pages come 4K
+        const auto mappedBytes = bytes + HUGE_PAGE_SIZE;
+        auto* mapped = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapped == MAP_FAILED) [[unlikely]] {
+            return nullptr;
+        }
+        const auto mappedStart = reinterpret_cast<std::uintptr_t>(mapped);
+        const auto alignedStart = (mappedStart + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        // Trim the unaligned head and the tail, so that unmapHugePages(region, bytes) releases it all
+        const auto headBytes = alignedStart - mappedStart;
+        if (headBytes) {
+            munmap(mapped, headBytes);
+        }
+        const auto tailBytes = mappedBytes - headBytes - bytes;
+        if (tailBytes) {
+            munmap(reinterpret_cast<void*>(alignedStart + bytes), tailBytes);
+        }
+        region = reinterpret_cast<void*>(alignedStart);
+#ifdef MADV_HUGEPAGE
+        madvise(region, bytes, MADV_HUGEPAGE);
+#endif
+#ifdef MADV_POPULATE_WRITE
+        madvise(region, bytes, MADV_POPULATE_WRITE);
+#endif
+    }
+
+    // MAP_POPULATE and MADV_POPULATE_WRITE may be unavailable or fail, touch every page to be sure it is resident
+    const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto* bytesPtr = static_cast<volatile std::uint8_t*>(region);
+    for (std::size_t offset = 0; offset < bytes; offset += pageSize) {
+        bytesPtr[offset] = 0;
+    }
+
+    mlock(region, bytes);
+    return region;
+}
+
+/**
+ * @brief Releases a region returned by mapHugePages().
+ * @param region The start of the region.
+ * @param bytes The size the region was mapped with.
+ */
+inline auto unmapHugePages(void* region, std::size_t bytes) noexcept -> void {
+    munlock(region, bytes);
+    munmap(region, bytes);
+}
+
+/**
+ * @class HugePageAllocator
+ * @brief Standard allocator handing out prefaulted, locked, huge page backed memory.
+ *
+ * Meant for the large fixed-size containers allocated once at startup (pools, queues, order
+ * storage): every allocation is its own mapping rounded up to HUGE_PAGE_SIZE, so it is a poor
+ * fit for containers that grow or allocate small blocks often.
+ *
+ * @tparam T The type of objects to allocate.
+ */
+template <typename T>
+class HugePageAllocator {
+  public:
+    using value_type = T;
+
+    HugePageAllocator() noexcept = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    /**
+     * @brief Allocates storage for n objects of type T.
+     * @throws std::bad_alloc if the region cannot be mapped.
+     */
+    [[nodiscard]] auto allocate(std::size_t n) -> T* {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) [[unlikely]] {
+            throw std::bad_alloc();
+        }
+        auto* region = mapHugePages(roundUp(n * sizeof(T)));
+        if (!region) [[unlikely]] {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(region);
+    }
+
+    /**
+     * @brief Releases storage previously obtained from allocate(n).
+     */
+    auto deallocate(T* ptr, std::size_t n) noexcept -> void {
+        unmapHugePages(ptr, roundUp(n * sizeof(T)));
+    }
+
+    template <typename U>
+    auto operator==(const HugePageAllocator<U>&) const noexcept -> bool { return true; }
+
+  private:
+    [[nodiscard]] static constexpr auto roundUp(std::size_t bytes) noexcept -> std::size_t {
+        return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+};
+
+} // namespace utils
+
+#endif // LOW_LATENCY_TRADING_APP_HUGE_PAGE_ALLOCATOR_H
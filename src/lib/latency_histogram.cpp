@@ -0,0 +1,24 @@
+#include "latency_histogram.h"
+
+namespace utils {
+
+auto LatencyMonitor::collect(std::size_t stage, LatencyHistogram& out) noexcept -> void {
+    const auto nThreadSets = nThreadSets_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < nThreadSets; ++i) {
+        out.merge((*threadSets_[i])[stage]);
+    }
+}
+
+auto LatencyMonitor::registerThread() noexcept -> StageHistograms* {
+    std::scoped_lock lock(registerMutex_);
+    const auto nThreadSets = nThreadSets_.load(std::memory_order_relaxed);
+    if (nThreadSets == MAX_LATENCY_THREADS) [[unlikely]] {
+        return nullptr;
+    }
+    threadSets_[nThreadSets] = std::make_unique<StageHistograms>();
+    nThreadSets_.store(nThreadSets + 1, std::memory_order_release);
+    threadHistograms_ = threadSets_[nThreadSets].get();
+    return threadHistograms_;
+}
+
+} // namespace utils
@@ -0,0 +1,205 @@
+#ifndef LOW_LATENCY_TRADING_APP_LATENCY_HISTOGRAM_H
+#define LOW_LATENCY_TRADING_APP_LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "time_utils.h"
+
+/**
+ * @file latency_histogram.h
+ * @brief Log-linear latency histograms recorded per thread without locks nor allocation.
+ */
+
+namespace utils {
+
+/// @brief Log2 of the number of buckets per power of two, bounding the relative error to 1/32
+inline constexpr int LATENCY_SUB_BUCKET_BITS = 5;
+/// @brief Latencies are tracked up to 2^LATENCY_MAX_BITS - 1 ns (about 18 minutes), longer ones are clamped
+inline constexpr int LATENCY_MAX_BITS = 40;
+/// @brief Maximum number of stages a LatencyMonitor tracks
+inline constexpr std::size_t MAX_LATENCY_STAGES = 16;
+/// @brief Maximum number of threads recording latencies
+inline constexpr std::size_t MAX_LATENCY_THREADS = 64;
+
+/**
+ * @class LatencyHistogram
+ * @brief HDR-style histogram of nanosecond latencies.
+ *
+ * Values below 2^(LATENCY_SUB_BUCKET_BITS + 1) have a bucket each. Each following power of two
+ * is split into 2^LATENCY_SUB_BUCKET_BITS equal buckets, so a bucket spans at most 1/32 of its
+ * values whatever their magnitude, in 9 KB.
+ *
+ * record() must be called by a single thread. The counters are atomics written with plain
+ * loads and stores, so other threads can merge() the histogram at any time and see a slightly
+ * stale but never torn state.
+ */
+class LatencyHistogram {
+  public:
+    /// @brief Number of buckets
+    static constexpr std::size_t N_BUCKETS = std::size_t{LATENCY_MAX_BITS - LATENCY_SUB_BUCKET_BITS + 1} << LATENCY_SUB_BUCKET_BITS;
+
+    /**
+     * @brief Returns the bucket of a value.
+     */
+    [[nodiscard]] static constexpr auto getBucketIndex(std::uint64_t value) noexcept -> std::size_t {
+        value = std::min<std::uint64_t>(value, (std::uint64_t{1} << LATENCY_MAX_BITS) - 1);
+        const auto nBits = std::bit_width(value);
+        if (nBits <= LATENCY_SUB_BUCKET_BITS + 1) {
+            return static_cast<std::size_t>(value);
+        }
+        // The top LATENCY_SUB_BUCKET_BITS + 1 bits select the bucket within the power of two
+        const auto shift = nBits - LATENCY_SUB_BUCKET_BITS - 1;
+        return (static_cast<std::size_t>(shift) << LATENCY_SUB_BUCKET_BITS) + static_cast<std::size_t>(value >> shift);
+    }
+
+    /**
+     * @brief Returns the highest value of a bucket.
+     */
+    [[nodiscard]] static constexpr auto getBucketUpperBound(std::size_t index) noexcept -> std::uint64_t {
+        if (index < (std::size_t{2} << LATENCY_SUB_BUCKET_BITS)) {
+            return index;
+        }
+        const auto shift = (index >> LATENCY_SUB_BUCKET_BITS) - 1;
+        const auto mantissa = index - (shift << LATENCY_SUB_BUCKET_BITS);
+        return ((std::uint64_t{mantissa} + 1) << shift) - 1;
+    }
+
+    /**
+     * @brief Records a latency, negative values (clocks of different sources) count as 0.
+     */
+    auto record(Nanos latency) noexcept -> void {
+        const auto value = static_cast<std::uint64_t>(std::max<Nanos>(latency, 0));
+        increment(counts_[getBucketIndex(value)], 1);
+        increment(count_, 1);
+        increment(sum_, value);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Adds the values of another histogram to this one. This histogram must not be recorded to concurrently.
+     */
+    auto merge(const LatencyHistogram& other) noexcept -> void {
+        for (std::size_t i = 0; i < N_BUCKETS; ++i) {
+            increment(counts_[i], other.counts_[i].load(std::memory_order_relaxed));
+        }
+        increment(count_, other.count_.load(std::memory_order_relaxed));
+        increment(sum_, other.sum_.load(std::memory_order_relaxed));
+        max_.store(std::max(max_.load(std::memory_order_relaxed), other.max_.load(std::memory_order_relaxed)),
+                   std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the number of values recorded.
+     */
+    [[nodiscard]] auto getCount() const noexcept -> std::uint64_t {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the largest value recorded, exact unlike the percentiles.
+     */
+    [[nodiscard]] auto getMax() const noexcept -> std::uint64_t {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the mean of the values recorded, 0 if none.
+     */
+    [[nodiscard]] auto getMean() const noexcept -> double {
+        const auto count = getCount();
+        return count ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(count) : 0.0;
+    }
+
+    /**
+     * @brief Returns the value below or at which a percentage of the values fall.
+     * @param percentile The percentage, from 0 to 100.
+     * @return The upper bound of the bucket holding the percentile, capped at the maximum; 0 if empty.
+     */
+    [[nodiscard]] auto getPercentile(double percentile) const noexcept -> std::uint64_t {
+        const auto count = getCount();
+        if (!count) {
+            return 0;
+        }
+        const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(count) + 0.5));
+        std::uint64_t nBelow = 0;
+        for (std::size_t i = 0; i < N_BUCKETS; ++i) {
+            nBelow += counts_[i].load(std::memory_order_relaxed);
+            if (nBelow >= rank) {
+                return std::min(getBucketUpperBound(i), getMax());
+            }
+        }
+        return getMax();
+    }
+
+  private:
+    static auto increment(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept -> void {
+        // Single writer: no read-modify-write instruction needed
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<std::uint64_t>, N_BUCKETS> counts_{}; ///< Number of values per bucket
+    std::atomic<std::uint64_t> count_{0}; ///< Number of values
+    std::atomic<std::uint64_t> sum_{0};   ///< Sum of the values, for the mean
+    std::atomic<std::uint64_t> max_{0};   ///< Largest value
+};
+
+/**
+ * @class LatencyMonitor
+ * @brief Latency histograms per stage, recorded by each thread into its own set.
+ *
+ * A thread registers its set on its first record(), the only time it allocates or locks. Sets
+ * are kept when their thread exits so no measurement is lost. collect() merges the sets of all
+ * threads for a stage, from any thread.
+ */
+class LatencyMonitor {
+  public:
+    LatencyMonitor() = delete;
+
+    /**
+     * @brief Records a latency for a stage from the calling thread.
+     * @param stage Index of the stage, below MAX_LATENCY_STAGES.
+     * @param latency The latency in nanoseconds.
+     */
+    static auto record(std::size_t stage, Nanos latency) noexcept -> void {
+        auto* histograms = threadHistograms_;
+        if (!histograms) [[unlikely]] {
+            histograms = registerThread();
+            if (!histograms) [[unlikely]] {
+                return;
+            }
+        }
+        (*histograms)[stage].record(latency);
+    }
+
+    /**
+     * @brief Adds the latencies recorded by all threads for a stage to a histogram.
+     */
+    static auto collect(std::size_t stage, LatencyHistogram& out) noexcept -> void;
+
+  private:
+    using StageHistograms = std::array<LatencyHistogram, MAX_LATENCY_STAGES>;
+
+    /**
+     * @brief Gives the calling thread its set of histograms.
+     * @return The set, or nullptr if MAX_LATENCY_THREADS threads already have one.
+     */
+    static auto registerThread() noexcept -> StageHistograms*;
+
+    inline static std::array<std::unique_ptr<StageHistograms>, MAX_LATENCY_THREADS> threadSets_{}; ///< Sets of all threads
+    inline static std::atomic<std::size_t> nThreadSets_{0};   ///< Number of entries of threadSets_ in use
+    inline static std::mutex registerMutex_;                  ///< Serializes registrations
+    inline static thread_local StageHistograms* threadHistograms_{nullptr}; ///< Set of the calling thread
+};
+
+} // namespace utils
+
+#endif // LOW_LATENCY_TRADING_APP_LATENCY_HISTOGRAM_H
@@ -8,20 +8,56 @@
 #ifndef LOW_LATENCY_TRADING_APP_LOCK_FREE_QUEUE_H
 #define LOW_LATENCY_TRADING_APP_LOCK_FREE_QUEUE_H
 
+#include <algorithm>
 #include <atomic>
+#include <bit>
 #include <vector>
 #include <cstddef>
+#include <memory>
 #include <optional>
+#include <span>
 
 #include "assertion.h"
+#include "wait_strategy.h"
 
 namespace utils {
 
-template <typename T>
+/// @brief Assumed size of a cache line, used to keep data written by different threads apart
+inline constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @class LFQueue
+ * @brief Bounded single-producer/single-consumer lock-free ring buffer.
+ *
+ * The read (head) and write (tail) indices grow monotonically and are mapped to slots with a
+ * mask over a power-of-two buffer, while the queue still holds at most the requested number of
+ * elements. The producer publishes a slot by storing the tail with release semantics and the
+ * consumer frees it by storing the head with release semantics. Each side also keeps a private
+ * copy of the other side's index on its own cache line, and reloads it only when the ring looks
+ * full (producer) or empty (consumer), so in steady state neither side reads the line the other
+ * one writes.
+ *
+ * Besides the element-wise push()/pop(), the producer can claim() contiguous slots, construct
+ * the elements in place and commit() them with a single index update, and the consumer can
+ * peekBatch() contiguous elements and consume() them with a single index update.
+ *
+ * A consumer parking with WaitStrategy::SPIN_PARK can attach a WaitSignal, which the producer
+ * then notifies after each publish; queues without one pay a single predictable branch.
+ *
+ * Exactly one thread may push and exactly one thread may pop at any time.
+ *
+ * @tparam T The type of the queued elements.
+ * @tparam Allocator Allocator for the element storage (e.g. HugePageAllocator).
+ */
+template <typename T, typename Allocator = std::allocator<T>>
 class LFQueue {
   public:
+    /**
+     * @brief Constructs a queue able to hold up to size elements.
+     * @param size The maximum number of queued elements.
+     */
     explicit LFQueue(std::size_t size)
-        : queue_(size){}
+        : capacity_(size), mask_(std::bit_ceil(std::max<std::size_t>(size, 1)) - 1), queue_(mask_ + 1) {}
 
     LFQueue() = delete;
     LFQueue(const LFQueue&) = delete;
@@ -29,7 +65,10 @@ class LFQueue {
     LFQueue& operator=(const LFQueue&) = delete;
     LFQueue& operator=(LFQueue&&) = delete;
 
-
+    /**
+     * @brief Copies a value into the queue. Producer only.
+     * @return false if the queue is full.
+     */
     bool push(const T& value) noexcept {
         auto* slot = getNextToWrite();
         if (!slot) [[unlikely]] return false;
@@ -38,6 +77,10 @@ class LFQueue {
         return true;
     }
 
+    /**
+     * @brief Removes and returns the oldest value of the queue. Consumer only.
+     * @return The value, or std::nullopt if the queue is empty.
+     */
     std::optional<T> pop() noexcept {
         const T* elem = getNextToRead();
         if (!elem) [[unlikely]] return std::nullopt;
@@ -46,36 +89,151 @@ class LFQueue {
         return value;
     }
 
+    /**
+     * @brief Claims up to n contiguous free slots to be filled in place. Producer only.
+     * @details The slots only become visible to the consumer once commit() is called. Fewer than
+     * n slots are returned when the queue is nearly full or the claim reaches the end of the
+     * buffer; claiming again after a commit continues from the start of the buffer.
+     * @param n The number of slots wanted.
+     * @return The claimed slots, empty if the queue is full.
+     */
+    [[nodiscard]] auto claim(std::size_t n) noexcept -> std::span<T> {
+        const auto tail = producer_.tail.load(std::memory_order_relaxed);
+        auto nFree = capacity_ - (tail - producer_.cachedHead);
+        if (nFree < n) {
+            producer_.cachedHead = consumer_.head.load(std::memory_order_acquire);
+            nFree = capacity_ - (tail - producer_.cachedHead);
+        }
+        const auto slot = tail & mask_;
+        return {&queue_[slot], std::min({n, nFree, queue_.size() - slot})};
+    }
+
+    /**
+     * @brief Publishes the first n slots returned by the last claim(). Producer only.
+     */
+    auto commit(std::size_t n) noexcept -> void {
+        const auto tail = producer_.tail.load(std::memory_order_relaxed);
+        ASSERT_CONDITION(tail + n - producer_.cachedHead <= capacity_, "Committing {} slots past the claimed ones.", n);
+        producer_.tail.store(tail + n, std::memory_order_release);
+        notifyConsumer();
+    }
+
+    /**
+     * @brief Returns up to n of the oldest queued elements without removing them. Consumer only.
+     * @details Fewer than n elements are returned when the batch reaches the end of the buffer.
+     * @param n The maximum number of elements wanted.
+     * @return The elements, contiguous and oldest first, empty if the queue is empty.
+     */
+    [[nodiscard]] auto peekBatch(std::size_t n) const noexcept -> std::span<const T> {
+        const auto head = consumer_.head.load(std::memory_order_relaxed);
+        if (consumer_.cachedTail - head < n) {
+            consumer_.cachedTail = producer_.tail.load(std::memory_order_acquire);
+        }
+        const auto slot = head & mask_;
+        return {&queue_[slot], std::min({n, consumer_.cachedTail - head, queue_.size() - slot})};
+    }
+
+    /**
+     * @brief Releases the first n elements returned by the last peekBatch(). Consumer only.
+     */
+    auto consume(std::size_t n) noexcept -> void {
+        const auto head = consumer_.head.load(std::memory_order_relaxed);
+        ASSERT_CONDITION(consumer_.cachedTail - head >= n, "Consuming {} elements past the available ones.", n);
+        consumer_.head.store(head + n, std::memory_order_release);
+    }
+
+    /**
+     * @brief Sets the signal notified after each push() or commit(), nullptr for none.
+     * @details Call before the producer starts.
+     */
+    auto setWaitSignal(WaitSignal* signal) noexcept -> void {
+        producer_.signal = signal;
+    }
+
+    /**
+     * @brief Returns the number of queued elements.
+     * @details Exact when called from the producer or the consumer while the other side is idle,
+     * otherwise a snapshot that may already be stale.
+     */
     [[nodiscard]] auto size() const noexcept -> std::size_t {
-        return numElements_.load(std::memory_order_relaxed);
+        const auto head = consumer_.head.load(std::memory_order_acquire);
+        return producer_.tail.load(std::memory_order_acquire) - head;
     }
 
+    /**
+     * @brief Returns the maximum number of queued elements.
+     */
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t {
+        return capacity_;
+    }
+
+    /**
+     * @brief Releases the slot returned by getNextToRead(). Consumer only.
+     */
     auto updateReadIndex() noexcept -> void {
-        ASSERT_CONDITION(numElements_ > 0, "No elements to read.");
-        nextIndexToRead_ = (nextIndexToRead_ + 1) % queue_.size();
-        numElements_.fetch_sub(1, std::memory_order_relaxed);
+        const auto head = consumer_.head.load(std::memory_order_relaxed);
+        ASSERT_CONDITION(head != consumer_.cachedTail, "No elements to read.");
+        consumer_.head.store(head + 1, std::memory_order_release);
     }
 
+    /**
+     * @brief Returns the oldest queued element without removing it. Consumer only.
+     * @return The element, or nullptr if the queue is empty.
+     */
     [[nodiscard]] auto getNextToRead() const noexcept -> const T* {
-        return numElements_ > 0 ? &queue_[nextIndexToRead_] : nullptr;
+        const auto head = consumer_.head.load(std::memory_order_relaxed);
+        if (head == consumer_.cachedTail) {
+            consumer_.cachedTail = producer_.tail.load(std::memory_order_acquire);
+            if (head == consumer_.cachedTail) {
+                return nullptr;
+            }
+        }
+        return &queue_[head & mask_];
     }
 
   private:
     [[nodiscard]] auto getNextToWrite() noexcept -> T* {
-        return numElements_ < queue_.size() ? &queue_[nextIndexToWrite_] : nullptr;
+        const auto tail = producer_.tail.load(std::memory_order_relaxed);
+        if (tail - producer_.cachedHead >= capacity_) {
+            producer_.cachedHead = consumer_.head.load(std::memory_order_acquire);
+            if (tail - producer_.cachedHead >= capacity_) {
+                return nullptr;
+            }
+        }
+        return &queue_[tail & mask_];
     }
 
     auto updateWriteIndex() noexcept -> void {
-        nextIndexToWrite_ = (nextIndexToWrite_ + 1) % queue_.size();
-        numElements_.fetch_add(1, std::memory_order_relaxed);
+        producer_.tail.store(producer_.tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        notifyConsumer();
+    }
+
+    auto notifyConsumer() noexcept -> void {
+        if (producer_.signal) [[unlikely]] {
+            producer_.signal->notify();
+        }
     }
 
-    std::atomic<std::size_t> nextIndexToRead_{0};
-    std::atomic<std::size_t> nextIndexToWrite_{0};
-    std::atomic<std::size_t> numElements_{0};
-    std::vector<T> queue_;
+    /// @brief Indices written by the producer
+    struct alignas(CACHE_LINE_SIZE) ProducerIndices {
+        std::atomic<std::size_t> tail{0}; ///< Total number of elements pushed
+        std::size_t cachedHead{0};        ///< Last head seen by the producer
+        WaitSignal* signal{nullptr};      ///< Notified after each publish, see setWaitSignal()
+    };
+
+    /// @brief Indices written by the consumer
+    struct alignas(CACHE_LINE_SIZE) ConsumerIndices {
+        std::atomic<std::size_t> head{0};   ///< Total number of elements popped
+        mutable std::size_t cachedTail{0};  ///< Last tail seen by the consumer
+    };
+
+    ProducerIndices producer_;
+    ConsumerIndices consumer_;
+    const std::size_t capacity_;          ///< Maximum number of queued elements
+    const std::size_t mask_;              ///< Buffer size minus one, the buffer size is a power of two
+    std::vector<T, Allocator> queue_;
 };
 
-} // namespace lib
+} // namespace utils
 
-#endif // LOW_LATENCY_TRADING_APP_LOCK_FREE_QUEUE_H
\ No newline at end of file
+#endif // LOW_LATENCY_TRADING_APP_LOCK_FREE_QUEUE_H
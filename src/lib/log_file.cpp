@@ -0,0 +1,102 @@
+#include "log_file.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace utils {
+
+namespace {
+
+constexpr std::size_t FORMAT_ENTRY_FIXED_SIZE = 1 + 2 * sizeof(std::uint16_t);
+constexpr std::size_t RECORD_ENTRY_FIXED_SIZE = 1 + sizeof(LogRecordHeader);
+
+template <typename T>
+auto appendBytes(const T& value, std::string& out) -> void {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+auto appendLogFileHeader(std::string& out) -> void {
+    out.push_back(static_cast<char>(LogFileEntryType::FILE_HEADER));
+    out.append(LOG_FILE_MAGIC.data(), LOG_FILE_MAGIC.size());
+}
+
+auto appendLogFormatEntry(std::uint16_t formatId, std::string_view format, std::string& out) -> void {
+    const auto length = static_cast<std::uint16_t>(std::min<std::size_t>(format.size(), UINT16_MAX));
+    out.push_back(static_cast<char>(LogFileEntryType::FORMAT));
+    appendBytes(formatId, out);
+    appendBytes(length, out);
+    out.append(format.data(), length);
+}
+
+auto appendLogRecordEntry(const LogRecord& record, std::string& out) -> void {
+    out.push_back(static_cast<char>(LogFileEntryType::RECORD));
+    appendBytes(record.header, out);
+    out.append(reinterpret_cast<const char*>(record.payload.data()), record.header.payloadSize);
+}
+
+auto readLogFileEntry(std::span<const std::byte> data, LogFileEntry& entry, std::size_t& nBytes) noexcept
+    -> LogFileReadStatus {
+    if (data.empty()) {
+        return LogFileReadStatus::INCOMPLETE;
+    }
+
+    const auto type = static_cast<LogFileEntryType>(data[0]);
+    switch (type) {
+    case LogFileEntryType::FILE_HEADER: {
+        const auto size = 1 + LOG_FILE_MAGIC.size();
+        if (data.size() < size) {
+            return LogFileReadStatus::INCOMPLETE;
+        }
+        if (std::memcmp(data.data() + 1, LOG_FILE_MAGIC.data(), LOG_FILE_MAGIC.size()) != 0) {
+            return LogFileReadStatus::CORRUPT;
+        }
+        entry.type = type;
+        nBytes = size;
+        return LogFileReadStatus::OK;
+    }
+    case LogFileEntryType::FORMAT: {
+        if (data.size() < FORMAT_ENTRY_FIXED_SIZE) {
+            return LogFileReadStatus::INCOMPLETE;
+        }
+        std::uint16_t formatId = 0;
+        std::uint16_t length = 0;
+        std::memcpy(&formatId, data.data() + 1, sizeof(formatId));
+        std::memcpy(&length, data.data() + 1 + sizeof(formatId), sizeof(length));
+        if (formatId >= MAX_LOG_FORMATS) {
+            return LogFileReadStatus::CORRUPT;
+        }
+        if (data.size() < FORMAT_ENTRY_FIXED_SIZE + length) {
+            return LogFileReadStatus::INCOMPLETE;
+        }
+        entry.type = type;
+        entry.formatId = formatId;
+        entry.format = {reinterpret_cast<const char*>(data.data() + FORMAT_ENTRY_FIXED_SIZE), length};
+        nBytes = FORMAT_ENTRY_FIXED_SIZE + length;
+        return LogFileReadStatus::OK;
+    }
+    case LogFileEntryType::RECORD: {
+        if (data.size() < RECORD_ENTRY_FIXED_SIZE) {
+            return LogFileReadStatus::INCOMPLETE;
+        }
+        LogRecordHeader header;
+        std::memcpy(&header, data.data() + 1, sizeof(header));
+        if (header.payloadSize > entry.record.payload.size() || header.level > LogLevel::ERROR ||
+            header.formatId >= MAX_LOG_FORMATS) {
+            return LogFileReadStatus::CORRUPT;
+        }
+        if (data.size() < RECORD_ENTRY_FIXED_SIZE + header.payloadSize) {
+            return LogFileReadStatus::INCOMPLETE;
+        }
+        entry.type = type;
+        entry.record.header = header;
+        std::memcpy(entry.record.payload.data(), data.data() + RECORD_ENTRY_FIXED_SIZE, header.payloadSize);
+        nBytes = RECORD_ENTRY_FIXED_SIZE + header.payloadSize;
+        return LogFileReadStatus::OK;
+    }
+    }
+    return LogFileReadStatus::CORRUPT;
+}
+
+} // namespace utils
@@ -0,0 +1,97 @@
+#ifndef LOW_LATENCY_TRADING_APP_LOG_FILE_H
+#define LOW_LATENCY_TRADING_APP_LOG_FILE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "log_record.h"
+
+/**
+ * @file log_file.h
+ * @brief Layout of binary log files, written by the logger and rendered offline by log_decode.
+ *
+ * A binary log file is a stream of entries, each starting with a LogFileEntryType byte:
+ * - FILE_HEADER: the LOG_FILE_MAGIC bytes, written whenever the logger switches to a new file;
+ * - FORMAT: format ID (2 bytes), length (2 bytes) and characters of a format string, written
+ *   before the first record of the file using it;
+ * - RECORD: a LogRecordHeader followed by its payloadSize payload bytes.
+ *
+ * Integers are stored in host byte order. Rotated files continue the stream of the file before
+ * them, an entry may straddle two of them: they are decoded as one stream, in rotation order.
+ */
+
+namespace utils {
+
+/**
+ * @brief Whether the logger writes formatted text lines or binary entries.
+ */
+enum class LogFileFormat : std::uint8_t {
+    TEXT,  ///< One formatted line per record.
+    BINARY ///< Raw records and their format strings, see log_file.h. Formatting is left to log_decode.
+};
+
+/**
+ * @brief Type of an entry of a binary log file.
+ */
+enum class LogFileEntryType : std::uint8_t {
+    FILE_HEADER = 1, ///< Start of a file written by the logger
+    FORMAT = 2,      ///< Format string of the records with a format ID
+    RECORD = 3       ///< Log record
+};
+
+/// @brief Identifies binary log files, the last two characters are the version of the layout
+inline constexpr std::array<char, 8> LOG_FILE_MAGIC{'H', 'F', 'T', 'L', 'O', 'G', '0', '1'};
+/// @brief Size of the largest entry, a FORMAT entry with the longest format string
+inline constexpr std::size_t MAX_LOG_FILE_ENTRY_SIZE = 1 + 2 * sizeof(std::uint16_t) + UINT16_MAX;
+
+/**
+ * @brief Appends a FILE_HEADER entry to a buffer.
+ */
+auto appendLogFileHeader(std::string& out) -> void;
+
+/**
+ * @brief Appends a FORMAT entry to a buffer. Format strings longer than 65535 characters are truncated.
+ */
+auto appendLogFormatEntry(std::uint16_t formatId, std::string_view format, std::string& out) -> void;
+
+/**
+ * @brief Appends a RECORD entry to a buffer, with only the payload bytes in use.
+ */
+auto appendLogRecordEntry(const LogRecord& record, std::string& out) -> void;
+
+/**
+ * @struct LogFileEntry
+ * @brief Entry read from a binary log file.
+ */
+struct LogFileEntry {
+    LogFileEntryType type{LogFileEntryType::RECORD}; ///< Type of the entry
+    std::uint16_t formatId{0};                       ///< FORMAT: ID of the format string
+    std::string_view format;                         ///< FORMAT: the format string, pointing into the data read
+    LogRecord record{};                              ///< RECORD: the record
+};
+
+/**
+ * @brief Outcome of readLogFileEntry().
+ */
+enum class LogFileReadStatus : std::uint8_t {
+    OK,         ///< An entry was read.
+    INCOMPLETE, ///< The data ends in the middle of the entry.
+    CORRUPT     ///< The data does not hold a valid entry.
+};
+
+/**
+ * @brief Reads the entry at the start of some data.
+ * @param data Bytes of a binary log file, starting at an entry.
+ * @param entry Receives the entry. Only the fields of its type are updated.
+ * @param nBytes Receives the size of the entry when the status is OK.
+ */
+[[nodiscard]] auto readLogFileEntry(std::span<const std::byte> data, LogFileEntry& entry, std::size_t& nBytes) noexcept
+    -> LogFileReadStatus;
+
+} // namespace utils
+
+#endif // LOW_LATENCY_TRADING_APP_LOG_FILE_H
@@ -0,0 +1,128 @@
+#include "log_record.h"
+
+#include <atomic>
+#include <charconv>
+
+#include "assertion.h"
+
+namespace utils {
+
+namespace {
+
+std::array<std::string_view, MAX_LOG_FORMATS> logFormats_{};
+std::atomic<std::size_t> nLogFormats_{0};
+
+template <typename T>
+auto readLogBytes(const LogRecord& record, std::size_t& offset) noexcept -> T {
+    T value;
+    std::memcpy(&value, record.payload.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+}
+
+auto hasLogBytes(const LogRecord& record, std::size_t offset, std::size_t size) noexcept -> bool {
+    return offset + size <= record.header.payloadSize;
+}
+
+/**
+ * @brief Appends the argument at offset, returns false if the payload ends before it.
+ */
+auto appendLogArg(const LogRecord& record, std::size_t& offset, std::string& out) -> bool {
+    if (!hasLogBytes(record, offset, sizeof(LogArgType))) [[unlikely]] {
+        return false;
+    }
+    const auto type = readLogBytes<LogArgType>(record, offset);
+    switch (type) {
+        using enum utils::LogArgType;
+    case INT:
+    case UINT:
+    case DOUBLE:
+        if (!hasLogBytes(record, offset, 8)) [[unlikely]] {
+            return false;
+        }
+        break;
+    case BOOL:
+    case CHAR:
+        if (!hasLogBytes(record, offset, 1)) [[unlikely]] {
+            return false;
+        }
+        break;
+    case STRING:
+        if (!hasLogBytes(record, offset, sizeof(std::uint16_t))) [[unlikely]] {
+            return false;
+        }
+        break;
+    default: return false;
+    }
+
+    switch (type) {
+        using enum utils::LogArgType;
+    case INT: out.append(std::to_string(readLogBytes<std::int64_t>(record, offset))); break;
+    case UINT: out.append(std::to_string(readLogBytes<std::uint64_t>(record, offset))); break;
+    case DOUBLE: {
+        // Shortest round-trip form, as std::format("{}") prints it: 100.5 rather than 100.500000
+        std::array<char, 32> digits;
+        const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), readLogBytes<double>(record, offset));
+        out.append(digits.data(), result.ptr);
+        break;
+    }
+    case BOOL: out.append(readLogBytes<bool>(record, offset) ? "true" : "false"); break;
+    case CHAR: out.push_back(readLogBytes<char>(record, offset)); break;
+    case STRING: {
+        const auto length = readLogBytes<std::uint16_t>(record, offset);
+        if (!hasLogBytes(record, offset, length)) [[unlikely]] {
+            return false;
+        }
+        out.append(reinterpret_cast<const char*>(record.payload.data() + offset), length);
+        offset += length;
+        break;
+    }
+    }
+    return true;
+}
+
+} // namespace
+
+auto registerLogFormat(std::string_view format) noexcept -> std::uint16_t {
+    const auto formatId = nLogFormats_.fetch_add(1, std::memory_order_relaxed);
+    ASSERT_CONDITION(formatId < MAX_LOG_FORMATS, "Too many log formats registered, max: {}", MAX_LOG_FORMATS);
+    logFormats_[formatId] = format;
+    return static_cast<std::uint16_t>(formatId);
+}
+
+auto getLogFormat(std::uint16_t formatId) noexcept -> std::string_view {
+    return formatId < MAX_LOG_FORMATS ? logFormats_[formatId] : std::string_view{};
+}
+
+auto getLogFormatCount() noexcept -> std::size_t {
+    return std::min(nLogFormats_.load(std::memory_order_relaxed), MAX_LOG_FORMATS);
+}
+
+auto formatLogMessage(const LogRecord& record, std::string_view format, std::string& out) -> void {
+    std::size_t offset = 0;
+    std::size_t nArgsLeft = record.header.nArgs;
+    for (std::size_t i = 0; i < format.size(); ++i) {
+        if (nArgsLeft && format[i] == '{' && i + 1 < format.size() && format[i + 1] == '}') {
+            if (appendLogArg(record, offset, out)) [[likely]] {
+                --nArgsLeft;
+            } else {
+                nArgsLeft = 0;
+                out.append("{}");
+            }
+            ++i;
+        } else {
+            out.push_back(format[i]);
+        }
+    }
+}
+
+auto appendLogLinePrefix(const LogRecordHeader& header, std::string& out) -> void {
+    thread_local TimestampFormatter timestampFormatter;
+    out.push_back('[');
+    out.append(timestampFormatter.format(header.timestamp));
+    out.append("] [");
+    out.append(logLevelToStr(header.level));
+    out.append("] ");
+}
+
+} // namespace utils
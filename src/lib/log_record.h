@@ -0,0 +1,194 @@
+#ifndef LOW_LATENCY_TRADING_APP_LOG_RECORD_H
+#define LOW_LATENCY_TRADING_APP_LOG_RECORD_H
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "time_utils.h"
+
+/**
+ * @file log_record.h
+ * @brief Fixed-size binary log records written by the logging hot path and formatted later.
+ */
+
+namespace utils {
+
+/**
+ * @brief Enumeration of log levels.
+ */
+enum class LogLevel : std::uint8_t {
+    DEBUG,   ///< Detailed information, typically of interest only when diagnosing problems.
+    INFO,    ///< Confirmation that things are working as expected.
+    WARNING, ///< An indication that something unexpected happened, or indicative of some problem in the near future.
+    ERROR    ///< Due to a more serious problem, the software has not been able to perform some function.
+};
+
+/**
+ * @brief Returns the display name of a log level.
+ */
+[[nodiscard]] constexpr auto logLevelToStr(LogLevel level) noexcept -> std::string_view {
+    switch (level) {
+        using enum utils::LogLevel;
+    case DEBUG: return "DEBUG";
+    case INFO: return "INFO";
+    case WARNING: return "WARNING";
+    case ERROR: return "ERROR";
+    }
+    return "UNKNOWN";
+}
+
+/// @brief Size in bytes of a log record, header included
+inline constexpr std::size_t LOG_RECORD_SIZE = 256;
+/// @brief Maximum number of distinct format strings (LOG_* call sites) in a process
+inline constexpr std::size_t MAX_LOG_FORMATS = 4096;
+
+/**
+ * @brief Type tag preceding each argument in the payload of a LogRecord.
+ */
+enum class LogArgType : std::uint8_t {
+    INT,    ///< Signed integer, stored as 8 bytes
+    UINT,   ///< Unsigned integer, stored as 8 bytes
+    DOUBLE, ///< Floating point, stored as 8 bytes
+    BOOL,   ///< Boolean, stored as 1 byte
+    CHAR,   ///< Single character, stored as 1 byte
+    STRING  ///< Character string, stored as a 2-byte length followed by the characters
+};
+
+/**
+ * @struct LogRecordHeader
+ * @brief Fixed part of a LogRecord.
+ */
+struct LogRecordHeader {
+    Nanos timestamp{0};           ///< Time the record was logged
+    std::uint16_t formatId{0};    ///< ID of the format string, see registerLogFormat()
+    LogLevel level{LogLevel::INFO}; ///< Log level of the record
+    std::uint8_t nArgs{0};        ///< Number of arguments in the payload
+    std::uint16_t payloadSize{0}; ///< Number of payload bytes in use
+    std::uint16_t threadId{0};    ///< Log ring of the logging thread, reused by later threads once it exits
+};
+static_assert(sizeof(LogRecordHeader) == 16, "LogRecordHeader should have no padding, it is written as is to binary log files");
+
+/**
+ * @struct LogRecord
+ * @brief A log message in binary form: format string ID plus type-tagged raw argument bytes.
+ *
+ * Arguments that do not fit in the payload are dropped, and the last string argument that
+ * does not fit entirely is truncated, so encoding never allocates or fails.
+ */
+struct alignas(64) LogRecord {
+    LogRecordHeader header{};                                                 ///< Record metadata
+    std::array<std::byte, LOG_RECORD_SIZE - sizeof(LogRecordHeader)> payload{}; ///< Encoded arguments
+};
+static_assert(sizeof(LogRecord) == LOG_RECORD_SIZE, "LogRecord should be exactly LOG_RECORD_SIZE bytes");
+
+/**
+ * @brief Registers a format string and returns its ID.
+ * @details Thread-safe. Meant to be called once per call site, the LOG_* macros cache the ID in
+ * a function-local static. The format string must outlive the process (a string literal).
+ */
+[[nodiscard]] auto registerLogFormat(std::string_view format) noexcept -> std::uint16_t;
+
+/**
+ * @brief Returns the format string registered under an ID.
+ * @details Safe to call for any ID seen in a record received through a queue from the
+ * registering thread.
+ */
+[[nodiscard]] auto getLogFormat(std::uint16_t formatId) noexcept -> std::string_view;
+
+/**
+ * @brief Returns the number of registered format strings.
+ */
+[[nodiscard]] auto getLogFormatCount() noexcept -> std::size_t;
+
+/**
+ * @brief Appends the message of a record to a string, substituting each "{}" of the format
+ * string with the next argument.
+ * @details Placeholders left without an argument are kept as is. Arguments extending past the
+ * payload in use, as in a corrupted record read from a file, are not substituted.
+ */
+auto formatLogMessage(const LogRecord& record, std::string_view format, std::string& out) -> void;
+
+/**
+ * @brief Appends the "[<time>] [<LEVEL>] " prefix of the text form of a record.
+ */
+auto appendLogLinePrefix(const LogRecordHeader& header, std::string& out) -> void;
+
+namespace detail {
+
+template <typename T>
+inline constexpr bool alwaysFalse = false;
+
+template <typename T>
+inline auto appendLogBytes(LogRecord& record, const T& value) noexcept -> void {
+    std::memcpy(record.payload.data() + record.header.payloadSize, &value, sizeof(T));
+    record.header.payloadSize = static_cast<std::uint16_t>(record.header.payloadSize + sizeof(T));
+}
+
+template <typename T>
+inline auto encodeLogArg(LogRecord& record, const T& arg) noexcept -> void {
+    using Arg = std::remove_cvref_t<T>;
+    const std::size_t available = record.payload.size() - record.header.payloadSize;
+
+    if constexpr (std::is_enum_v<Arg>) {
+        encodeLogArg(record, static_cast<std::underlying_type_t<Arg>>(arg));
+        return;
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        if (available <= 1 + sizeof(std::uint16_t)) [[unlikely]] {
+            return;
+        }
+        const std::string_view str{arg};
+        const auto length = static_cast<std::uint16_t>(std::min(str.size(), available - 1 - sizeof(std::uint16_t)));
+        appendLogBytes(record, LogArgType::STRING);
+        appendLogBytes(record, length);
+        std::memcpy(record.payload.data() + record.header.payloadSize, str.data(), length);
+        record.header.payloadSize = static_cast<std::uint16_t>(record.header.payloadSize + length);
+    } else {
+        constexpr auto typeAndSize = []() -> std::pair<LogArgType, std::size_t> {
+            if constexpr (std::same_as<Arg, bool>) return {LogArgType::BOOL, 1};
+            else if constexpr (std::same_as<Arg, char>) return {LogArgType::CHAR, 1};
+            else if constexpr (std::signed_integral<Arg>) return {LogArgType::INT, 8};
+            else if constexpr (std::unsigned_integral<Arg>) return {LogArgType::UINT, 8};
+            else if constexpr (std::floating_point<Arg>) return {LogArgType::DOUBLE, 8};
+            else static_assert(alwaysFalse<Arg>, "Unsupported log argument type");
+        }();
+        constexpr auto type = typeAndSize.first;
+        if (available < 1 + typeAndSize.second) [[unlikely]] {
+            return;
+        }
+        appendLogBytes(record, type);
+        if constexpr (type == LogArgType::INT) appendLogBytes(record, static_cast<std::int64_t>(arg));
+        else if constexpr (type == LogArgType::UINT) appendLogBytes(record, static_cast<std::uint64_t>(arg));
+        else if constexpr (type == LogArgType::DOUBLE) appendLogBytes(record, static_cast<double>(arg));
+        else appendLogBytes(record, arg);
+    }
+    ++record.header.nArgs;
+}
+
+} // namespace detail
+
+/**
+ * @brief Writes a log message into a record without allocating or formatting.
+ * @param record The record to fill.
+ * @param level The log level of the message.
+ * @param formatId The ID of the format string, see registerLogFormat().
+ * @param timestamp The time of the message.
+ * @param args Integral, floating point, bool, char, enum or string-like arguments.
+ */
+template <typename... Args>
+inline auto encodeLogRecord(LogRecord& record, LogLevel level, std::uint16_t formatId, Nanos timestamp,
+                            const Args&... args) noexcept -> void {
+    record.header = {timestamp, formatId, level, 0, 0, 0};
+    (detail::encodeLogArg(record, args), ...);
+}
+
+} // namespace utils
+
+#endif // LOW_LATENCY_TRADING_APP_LOG_RECORD_H
@@ -4,16 +4,39 @@
 
 #include <format>
 #include <mutex>
-#include <typeindex>
 
 namespace utils {
-std::ofstream Logger::logFile_;
-std::mutex Logger::setLogFileMutex_;
 
-Logger::Logger(std::string_view logFilePath): logQueue_(LOG_QUEUE_SIZE){
+namespace {
+
+/**
+ * @brief Returns the writer of the log file, created on first use so it outlives the Logger.
+ */
+auto getLogWriter() -> AsyncFileWriter& {
+    static AsyncFileWriter writer;
+    return writer;
+}
+
+/// @brief Thread ID stamped on the records of the logger thread itself
+constexpr std::uint16_t LOGGER_THREAD_ID = MAX_LOG_THREADS;
+
+/**
+ * @brief Releases the log ring of a thread when the thread exits.
+ */
+struct ThreadRingOwner {
+    std::atomic<bool>* isOwned{nullptr};
+
+    ~ThreadRingOwner() {
+        if (isOwned) {
+            isOwned->store(false, std::memory_order_release);
+        }
+    }
+};
+
+} // namespace
+
+Logger::Logger(std::string_view logFilePath) {
     setLogFile(logFilePath);
-//    logFile_.open(logFilePath.data(), std::ios::out | std::ios::app);
-    ASSERT_CONDITION(logFile_.is_open(), "Failed to open log file: {}", logFilePath);
     logThread_ = createAndStartThread(-1, "logger {}", [this]{flushQueue();});
     ASSERT_CONDITION(logThread_ != nullptr, "Failed to create logger thread");
 }
@@ -23,68 +46,236 @@ Logger::~Logger() {
     if (logThread_ && logThread_->joinable()) {
         logThread_->join();
     }
-    logFile_.close();
+    getLogWriter().sync();
+}
+
+void Logger::setLogFile(std::string_view logFilePath, const FileWriterOptions& options, LogFileFormat format) {
+    const auto isOpen = getLogWriter().open(logFilePath, options);
+    ASSERT_CONDITION(isOpen, "Failed to open log file: {}", logFilePath);
+    fileFormat_.store(format, std::memory_order_relaxed);
+    fileGeneration_.fetch_add(1, std::memory_order_release);
+}
+
+auto Logger::registerThreadRing() noexcept -> ThreadLogRing* {
+    static thread_local ThreadRingOwner owner;
+    std::scoped_lock<std::mutex> registerLock(registerRingMutex_);
+
+    ThreadLogRing* ring = nullptr;
+    const auto nRings = nRings_.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < nRings && !ring; ++i) {
+        // The acquire pairs with the release of the exited owner, making its writes visible
+        bool isOwned = false;
+        if (rings_[i]->isOwned.compare_exchange_strong(isOwned, true, std::memory_order_acquire)) {
+            ring = rings_[i].get();
+        }
+    }
+    if (!ring) {
+        if (nRings == MAX_LOG_THREADS) [[unlikely]] {
+            return nullptr;
+        }
+        rings_[nRings] = std::make_unique<ThreadLogRing>(LOG_RING_SIZE, static_cast<std::uint16_t>(nRings));
+        ring = rings_[nRings].get();
+        nRings_.store(nRings + 1, std::memory_order_release);
+    }
+
+    owner.isOwned = &ring->isOwned;
+    threadRing_ = ring;
+    return ring;
+}
+
+auto Logger::drainRings(std::string& buffer, std::size_t maxRecords) -> std::size_t {
+    const auto nRings = nRings_.load(std::memory_order_acquire);
+    std::size_t nDrained = 0;
+    for (; nDrained < maxRecords; ++nDrained) {
+        ThreadLogRing* oldestRing = nullptr;
+        const LogRecord* oldest = nullptr;
+        for (std::size_t i = 0; i < nRings; ++i) {
+            const auto* record = rings_[i]->records.getNextToRead();
+            if (record && (!oldest || record->header.timestamp < oldest->header.timestamp)) {
+                oldest = record;
+                oldestRing = rings_[i].get();
+            }
+        }
+        if (!oldest) {
+            break;
+        }
+        appendToBuffer(*oldest, buffer);
+        oldestRing->records.updateReadIndex();
+    }
+    return nDrained;
+}
+
+auto Logger::handleOverflow(ThreadLogRing& ring) noexcept -> std::span<LogRecord> {
+    // Only the owning thread writes its counters, plain load/store is enough
+    ring.nOverflows.store(ring.nOverflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    switch (getOverflowPolicy()) {
+        using enum utils::LogOverflowPolicy;
+    case BLOCK: {
+        auto slot = ring.records.claim(1);
+        while (slot.empty()) {
+            std::this_thread::yield();
+            slot = ring.records.claim(1);
+        }
+        return slot;
+    }
+    case DROP_OLDEST:
+        ring.isDiscardRequested.store(true, std::memory_order_relaxed);
+        [[fallthrough]];
+    case DROP_NEWEST:
+        ring.nDropped.store(ring.nDropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        break;
+    }
+    return {};
+}
+
+auto Logger::discardRequestedBacklogs() noexcept -> void {
+    const auto nRings = nRings_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < nRings; ++i) {
+        auto& ring = *rings_[i];
+        if (!ring.isDiscardRequested.exchange(false, std::memory_order_relaxed)) [[likely]] {
+            continue;
+        }
+        auto nToDiscard = ring.records.size() / 2;
+        nDiscarded_.fetch_add(nToDiscard, std::memory_order_relaxed);
+        while (nToDiscard) {
+            const auto batch = ring.records.peekBatch(nToDiscard);
+            ring.records.consume(batch.size());
+            nToDiscard -= batch.size();
+        }
+    }
+}
+
+auto Logger::getDroppedRecordCount() const noexcept -> std::uint64_t {
+    auto nDropped = nUnregisteredDropped_.load(std::memory_order_relaxed) + nDiscarded_.load(std::memory_order_relaxed);
+    const auto nRings = nRings_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < nRings; ++i) {
+        nDropped += rings_[i]->nDropped.load(std::memory_order_relaxed);
+    }
+    return nDropped;
+}
+
+auto Logger::getOverflowCount() const noexcept -> std::uint64_t {
+    std::uint64_t nOverflows = 0;
+    const auto nRings = nRings_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < nRings; ++i) {
+        nOverflows += rings_[i]->nOverflows.load(std::memory_order_relaxed);
+    }
+    return nOverflows;
+}
+
+auto Logger::appendDropReport(std::string& buffer) -> void {
+    const auto nDropped = getDroppedRecordCount();
+    if (nDropped == nReportedDropped_) [[likely]] {
+        return;
+    }
+    static const auto dropReportFormatId = registerLogFormat("Logger dropped {} records ({} in total)");
+    LogRecord report;
+    encodeLogRecord(report, LogLevel::WARNING, dropReportFormatId, getCurrentNanos(), nDropped - nReportedDropped_, nDropped);
+    report.header.threadId = LOGGER_THREAD_ID;
+    appendToBuffer(report, buffer);
+    nReportedDropped_ = nDropped;
 }
 
-void Logger::setLogFile(std::string_view logFilePath) {
-    std::scoped_lock<std::mutex> logFilePathock(setLogFileMutex_);
-    if (logFile_.is_open()) {
-        logFile_.close();
+auto Logger::startFileIfSwitched(std::string& buffer) -> void {
+    const auto fileGeneration = fileGeneration_.load(std::memory_order_acquire);
+    if (fileGeneration == fileGenerationStarted_) [[likely]] {
+        return;
+    }
+    fileGenerationStarted_ = fileGeneration;
+    isBinaryFile_ = fileFormat_.load(std::memory_order_relaxed) == LogFileFormat::BINARY;
+    isFormatWritten_.reset();
+    if (isBinaryFile_) {
+        appendLogFileHeader(buffer);
     }
-    logFile_.open(logFilePath.data(), std::ios::out | std::ios::app);
-    ASSERT_CONDITION(logFile_.is_open(), "Failed to open log file: {}", logFilePath);
 }
 
 void Logger::flushQueue() noexcept {
     std::string buffer;
-    while (running_.load(std::memory_order_acquire)) {
+    auto strategy = getWaitStrategy();
+    Waiter waiter(strategy, nullptr, LOG_MAX_IDLE_SLEEP);
+    bool isRunning = true;
+    std::size_t nDrained = 0;
+    // After stopping, keep going while the last pass was full, so the backlog is written out
+    while (isRunning || nDrained == LOG_DRAIN_BATCH) {
+        // Read the flag before draining, so the records logged before stopping are all written
+        isRunning = running_.load(std::memory_order_acquire);
+
         buffer.clear();
-        for (size_t i = 0; i < 100 && logQueue_.size(); ++i) {
-            if (auto next = logQueue_.pop()) {
-                appendToBuffer(*next, buffer);
-            }
-        }
+        startFileIfSwitched(buffer);
+        discardRequestedBacklogs();
+        nDrained = drainRings(buffer, LOG_DRAIN_BATCH);
+        appendDropReport(buffer);
         if (!buffer.empty()) {
             writeToFile(buffer);
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        if (nDrained == LOG_DRAIN_BATCH) {
+            // Backlogged: keep draining without pausing
+            continue;
+        }
+        if (getWaitStrategy() != strategy) [[unlikely]] {
+            strategy = getWaitStrategy();
+            waiter = Waiter(strategy, nullptr, LOG_MAX_IDLE_SLEEP);
+        }
+        if (nDrained) {
+            waiter.reset();
+            std::this_thread::yield();
+        } else if (isRunning && isPauseRequested_.load(std::memory_order_acquire)) [[unlikely]] {
+            holdWhilePaused();
+        } else if (isRunning) {
+            // Idle: without a signal, parking backs off exponentially up to LOG_MAX_IDLE_SLEEP
+            waiter.idle([]() { return false; });
+        }
     }
 }
 
+auto Logger::pauseDraining() noexcept -> void {
+    isPauseRequested_.store(true, std::memory_order_release);
+    while (!isPaused_.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+auto Logger::resumeDraining() noexcept -> void {
+    isPauseRequested_.store(false, std::memory_order_release);
+    // Wait for the logger thread to leave, so that a following pauseDraining() waits for it again
+    while (isPaused_.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+auto Logger::holdWhilePaused() noexcept -> void {
+    isPaused_.store(true, std::memory_order_release);
+    while (isPauseRequested_.load(std::memory_order_acquire) && running_.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::microseconds{100});
+    }
+    isPaused_.store(false, std::memory_order_release);
+}
+
 void Logger::writeToFile(const std::string& buffer) {
-    try {
-        logFile_ << buffer;
-        logFile_.flush();
+    // The writer thread does the write() calls, this only copies the buffer
+    auto& writer = getLogWriter();
+    writer.append(buffer);
+    writer.flush();
+}
 
-        if (!logFile_ || logFile_.bad()) {
-            throw std::ios_base::failure("Stream error");
+void Logger::appendToBuffer(const LogRecord& record, std::string& buffer) {
+    if (isBinaryFile_) {
+        const auto formatId = record.header.formatId;
+        if (!isFormatWritten_[formatId]) {
+            appendLogFormatEntry(formatId, getLogFormat(formatId), buffer);
+            isFormatWritten_.set(formatId);
         }
-    } catch (const std::ios_base::failure& e) {
-        std::cerr << "I/O error writing to log file: " << e.what() << std::endl;
-    } catch (const std::system_error& e) {
-        std::cerr << "System error writing to log file: " << e.what()
-                  << " (error code: " << e.code() << ")" << std::endl;
-    }
-}
-
-void Logger::appendToBuffer(const LogElement& elem, std::string& buffer) const {
-    const char* logLevel = [&]() {
-        switch (elem.level) {
-            using enum utils::LogLevel;
-        case DEBUG: return "DEBUG";
-        case INFO: return "INFO";
-        case WARNING: return "WARNING";
-        case ERROR: return "ERROR";
-        }
-        return "UNKNOWN";
-    }();
+        appendLogRecordEntry(record, buffer);
+        return;
+    }
 
-    buffer.append(std::format("[{}] [{}] ", getCurrentTimeStr(), logLevel));
+    appendLogLinePrefix(record.header, buffer);
 
-    // Format the message using the stored format string and arguments
+    // Format the message using the registered format string and the recorded arguments
     try {
-        std::string formatted_message = formatMessage(elem.formatString, elem.args);
-        buffer.append(formatted_message);
+        formatLogMessage(record, getLogFormat(record.header.formatId), buffer);
     } catch (const std::exception& e) {
         buffer.append("Error formatting log message: ");
         buffer.append(e.what());
@@ -92,45 +283,7 @@ void Logger::appendToBuffer(const LogElement& elem, std::string& buffer) const {
 
     buffer.push_back('\n');
 }
-std::string Logger::formatMessage(std::string_view format_string, const std::vector<std::any>& args) const {
-    std::string result(format_string);
-    size_t arg_index = 0;
-    for (size_t i = 0; i < result.size(); ++i) {
-        if (result[i] == '{' && i + 1 < result.size() && result[i + 1] == '}' && arg_index < args.size()) {
-            std::string arg_str = anyToString(args[arg_index]);
-            result.replace(i, 2, arg_str);
-            i += arg_str.length() - 1;
-            ++arg_index;
-        }
-    }
-    return result;
-}
-
-std::string Logger::anyToString(const std::any& arg) const {
-    if (arg.type() == typeid(int)) {
-        return std::to_string(std::any_cast<int>(arg));
-    } else if (arg.type() == typeid(std::size_t)) {
-        return std::to_string(std::any_cast<std::size_t>(arg));
-    } else if (arg.type() == typeid(double)) {
-        return std::to_string(std::any_cast<double>(arg));
-    } else if (arg.type() == typeid(long)) {
-        return std::to_string(std::any_cast<long>(arg));
-    }else if (arg.type() == typeid(float)) {
-        return std::to_string(std::any_cast<float>(arg));
-    } else if (arg.type() == typeid(char)) {
-        return std::string{1, std::any_cast<char>(arg)};
-    } else if (arg.type() == typeid(bool)) {
-        return std::any_cast<bool>(arg) ? "true" : "false";
-    } else if (arg.type() == typeid(std::string)) {
-        return std::any_cast<std::string>(arg);
-    } else if (arg.type() == typeid(const char*)) {
-        return std::string{std::any_cast<const char*>(arg)};
-    } else if(arg.type() ==typeid(Nanos)){
-        return convertNanosToTimeStr(std::any_cast<Nanos>(arg));
-    }
-
-    return "Unsupported type: " + std::string(arg.type().name());
-}
+
 Logger &Logger::getInstance(std::string_view logFilePath) {
         static Logger instance(logFilePath);
         return instance;
@@ -1,14 +1,24 @@
 #ifndef LOW_LATENCY_TRADING_APP_LOGGER_H
 #define LOW_LATENCY_TRADING_APP_LOGGER_H
 
+#include <array>
+#include <bitset>
 #include <atomic>
-#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
 #include <string_view>
 #include <thread>
 #include <memory>
-#include <any>
+#include <span>
 
+#include "async_file_writer.h"
+#include "huge_page_allocator.h"
 #include "lock_free_queue.h"
+#include "log_file.h"
+#include "log_record.h"
+#include "wait_strategy.h"
 
 /**
  * @file logger.h
@@ -17,18 +27,42 @@
 
 namespace utils {
 
-constexpr size_t LOG_QUEUE_SIZE = 8 * 1024 * 1024;
+/// @brief Number of LogRecord slots in the log ring of each thread (LOG_RECORD_SIZE bytes each)
+constexpr size_t LOG_RING_SIZE = 128 * 1024;
+/// @brief Maximum number of threads logging at the same time
+constexpr size_t MAX_LOG_THREADS = 64;
+/// @brief Maximum number of records formatted by the logger thread between two writes
+constexpr size_t LOG_DRAIN_BATCH = 4096;
+/// @brief Longest sleep of the logger thread when idle, with WaitStrategy::SPIN_PARK
+constexpr std::chrono::microseconds LOG_MAX_IDLE_SLEEP{10000};
 
 /**
- * @brief Enumeration of log levels.
+ * @brief What a logging thread does when its log ring is full.
  */
-enum class LogLevel {
-    DEBUG,   ///< Detailed information, typically of interest only when diagnosing problems.
-    INFO,    ///< Confirmation that things are working as expected.
-    WARNING, ///< An indication that something unexpected happened, or indicative of some problem in the near future.
-    ERROR    ///< Due to a more serious problem, the software has not been able to perform some function.
+enum class LogOverflowPolicy : std::uint8_t {
+    DROP_NEWEST, ///< Drop the message being logged.
+    DROP_OLDEST, ///< Drop the message being logged and have the logger thread discard the older half of the ring, unformatted, to keep the latest history.
+    BLOCK        ///< Wait for the logger thread to free a slot. Never loses a message but stalls the logging thread.
 };
 
+/**
+ * @def LOG_MIN_LEVEL
+ * @brief Lowest log level compiled in, as the numeric value of a utils::LogLevel.
+ *
+ * LOG_* calls below it are removed at compile time, arguments included. Defaults to INFO when
+ * NDEBUG is defined and to DEBUG otherwise.
+ */
+#ifndef LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_MIN_LEVEL 1
+#else
+#define LOG_MIN_LEVEL 0
+#endif
+#endif
+
+/// @brief Lowest log level compiled in, see LOG_MIN_LEVEL
+inline constexpr LogLevel LOG_COMPILE_TIME_MIN_LEVEL = static_cast<LogLevel>(LOG_MIN_LEVEL);
+
 /**
  * @class Logger
  * @brief A singleton class providing thread-safe, low-latency logging functionality.
@@ -36,6 +70,18 @@ enum class LogLevel {
  * This logger uses a lock-free queue to store log messages, which are then processed
  * and written to a file by a separate thread. This design minimizes the impact of
  * logging on the main application thread, making it suitable for low-latency environments.
+ *
+ * Messages are queued as fixed-size binary LogRecords holding a format string ID and the raw
+ * argument bytes: the logging thread never allocates nor formats, all formatting happens on
+ * the logger thread.
+ *
+ * Each logging thread registers its own single-producer/single-consumer ring on its first
+ * message, so producers never contend with each other. The logger thread drains all rings,
+ * always writing the oldest pending record first. The ring of an exited thread is handed over
+ * to the next thread registering.
+ *
+ * In LogFileFormat::BINARY mode the logger thread skips formatting too: it writes the records
+ * as is, each format string once per file, and the log_decode tool renders them offline.
  */
 class Logger {
   public:
@@ -60,39 +106,175 @@ class Logger {
     /**
      * @brief Log a message with the specified log level and format.
      *
-     * This method is variadic and type-safe. It accepts a format string and any number of arguments,
-     * similar to std::format. The formatting is deferred until the log is actually written to file.
+     * This method is variadic and type-safe. It accepts the ID of a format string with "{}"
+     * placeholders and any number of arguments. The arguments are copied in binary form and the
+     * formatting is deferred until the log is actually written to file.
      *
      * @param level The log level of the message.
-     * @param format_string The format string for the log message.
+     * @param formatId The ID of the format string, see registerLogFormat().
      * @param args The arguments to be formatted into the log message.
      */
     template <typename... Args>
-    void log(LogLevel level, std::string_view format_string, Args&&... args) noexcept {
-        LogElement elem{level, format_string, {}};
-        elem.args.reserve(sizeof...(Args));
-        (elem.args.emplace_back(std::forward<Args>(args)), ...);
-        logQueue_.push(elem);
+    void log(LogLevel level, std::uint16_t formatId, const Args&... args) noexcept {
+        auto* ring = threadRing_;
+        if (!ring) [[unlikely]] {
+            ring = registerThreadRing();
+            if (!ring) [[unlikely]] {
+                nUnregisteredDropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        auto slot = ring->records.claim(1);
+        if (slot.empty()) [[unlikely]] {
+            slot = handleOverflow(*ring);
+            if (slot.empty()) {
+                return;
+            }
+        }
+        encodeLogRecord(slot[0], level, formatId, getCurrentNanos(), args...);
+        slot[0].header.threadId = ring->id;
+        ring->records.commit(1);
     }
 
     /**
-     * @brief Set the log file to the specified path, it uses a mutex to ensure thread safety.
-     * @param logFilePath The path to the log file.
+     * @brief Sets the lowest level logged at runtime. Thread-safe.
+     * @details Messages below it are discarded by the LOG_* macros before their arguments are
+     * evaluated. Levels below LOG_MIN_LEVEL stay disabled whatever the runtime level.
+     */
+    static void setLogLevel(LogLevel level) noexcept {
+        minLevel_.store(level, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the lowest level logged at runtime.
+     */
+    [[nodiscard]] static LogLevel getLogLevel() noexcept {
+        return minLevel_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Checks whether messages of a level are currently logged.
+     */
+    [[nodiscard]] static bool isLevelEnabled(LogLevel level) noexcept {
+        return level >= minLevel_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sets what logging threads do when their ring is full. Thread-safe.
      */
+    static void setOverflowPolicy(LogOverflowPolicy policy) noexcept {
+        overflowPolicy_.store(policy, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns what logging threads do when their ring is full.
+     */
+    [[nodiscard]] static LogOverflowPolicy getOverflowPolicy() noexcept {
+        return overflowPolicy_.load(std::memory_order_relaxed);
+    }
 
-    static void setLogFile(std::string_view logFilePath);
+    /**
+     * @brief Sets what the logger thread does while no message is pending. Thread-safe.
+     * @details With WaitStrategy::SPIN_PARK, the default, the logging threads do not signal the
+     * logger thread, which keeps a fence off the logging path: it sleeps up to LOG_MAX_IDLE_SLEEP.
+     */
+    static void setWaitStrategy(WaitStrategy strategy) noexcept {
+        waitStrategy_.store(strategy, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns what the logger thread does while no message is pending.
+     */
+    [[nodiscard]] static WaitStrategy getWaitStrategy() noexcept {
+        return waitStrategy_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the number of messages lost so far, dropped by their thread or discarded unformatted.
+     */
+    [[nodiscard]] auto getDroppedRecordCount() const noexcept -> std::uint64_t;
+
+    /**
+     * @brief Returns the number of times a logging thread found its ring full.
+     */
+    [[nodiscard]] auto getOverflowCount() const noexcept -> std::uint64_t;
+
+    /**
+     * @brief Holds the logger thread once it finds every ring empty, until resumeDraining(). Thread-safe.
+     * @details Returns when the logger thread is held, so the records logged before are all drained
+     * and the rings then fill up deterministically, e.g. to exercise the overflow policies.
+     */
+    auto pauseDraining() noexcept -> void;
+
+    /**
+     * @brief Lets the logger thread drain the rings again after pauseDraining(). Thread-safe.
+     */
+    auto resumeDraining() noexcept -> void;
+
+    /**
+     * @brief Set the log file to the specified path. Thread-safe, records already handed to the
+     * file writer still go to the previous file.
+     * @param logFilePath The path to the log file.
+     * @param options Preallocation, direct I/O and rotation settings of the file.
+     * @param format Whether to write text lines or binary records to the file.
+     */
+    static void setLogFile(std::string_view logFilePath, const FileWriterOptions& options = {},
+                           LogFileFormat format = LogFileFormat::TEXT);
 
   private:
     /**
-     * @struct LogElement
-     * @brief Represents a single log entry in the queue.
+     * @struct ThreadLogRing
+     * @brief Log ring written by a single thread at a time.
      */
-    struct LogElement {
-        LogLevel level;                 ///< The log level of the message.
-        std::string_view formatString; ///< The format string for the log message.
-        std::vector<std::any> args;     ///< The arguments to be formatted into the log message.
+    struct alignas(CACHE_LINE_SIZE) ThreadLogRing {
+        ThreadLogRing(std::size_t size, std::uint16_t ringId) : records(size), id(ringId) {}
+
+        LFQueue<LogRecord, HugePageAllocator<LogRecord>> records; ///< Pending records of the owning thread
+        const std::uint16_t id;                                     ///< Thread ID stamped on the records
+        std::atomic<bool> isOwned{true};                            ///< Whether a live thread writes to the ring
+        std::atomic<bool> isDiscardRequested{false};                ///< Set by the owner under LogOverflowPolicy::DROP_OLDEST
+        std::atomic<std::uint64_t> nOverflows{0};                   ///< Times the owner found the ring full, owner-written
+        std::atomic<std::uint64_t> nDropped{0};                     ///< Messages dropped by the owner, owner-written
     };
 
+    /**
+     * @brief Applies the overflow policy once the ring of the calling thread is found full.
+     * @return A free slot under LogOverflowPolicy::BLOCK, an empty span otherwise.
+     */
+    auto handleOverflow(ThreadLogRing& ring) noexcept -> std::span<LogRecord>;
+
+    /**
+     * @brief Discards, unformatted, the older half of the rings whose owner asked for it.
+     */
+    auto discardRequestedBacklogs() noexcept -> void;
+
+    /**
+     * @brief Keeps the logger thread idle while pauseDraining() is in effect.
+     */
+    auto holdWhilePaused() noexcept -> void;
+
+    /**
+     * @brief Appends a warning to a buffer if messages were lost since the last call.
+     */
+    auto appendDropReport(std::string& buffer) -> void;
+
+    /**
+     * @brief Starts the output of a new log file if setLogFile() was called since the last call.
+     */
+    auto startFileIfSwitched(std::string& buffer) -> void;
+
+    /**
+     * @brief Gives the calling thread a log ring, reusing the ring of an exited thread if possible.
+     * @return The ring, or nullptr if MAX_LOG_THREADS threads already own one.
+     */
+    auto registerThreadRing() noexcept -> ThreadLogRing*;
+
+    /**
+     * @brief Formats up to maxRecords pending records into a buffer, oldest first across all rings.
+     * @return The number of records formatted.
+     */
+    auto drainRings(std::string& buffer, std::size_t maxRecords) -> std::size_t;
+
     /**
      * @brief Constructor. Initializes the logger with the specified log file.
      * @param logFilePath The path to the log file.
@@ -105,50 +287,69 @@ class Logger {
     auto flushQueue() noexcept -> void;
 
     /**
-     * @brief Writes the given buffer to the log file.
+     * @brief Hands the given buffer to the asynchronous file writer.
      * @param buffer The string buffer to write to the file.
      */
     auto writeToFile(const std::string& buffer) -> void;
 
     /**
-     * @brief Appends a formatted log message to the given buffer.
-     * @param elem The LogElement containing the log information.
+     * @brief Appends a formatted log message, or a binary entry in LogFileFormat::BINARY mode, to the given buffer.
+     * @param record The LogRecord containing the log information.
      * @param buffer The buffer to append the formatted log message to.
      */
-    auto appendToBuffer(const LogElement& elem, std::string& buffer) const -> void;
-
-    /**
-     * @brief Converts an std::any object to a string representation.
-     * @param arg The std::any object to convert.
-     * @return A string representation of the argument.
-     */
-    [[nodiscard]] auto anyToString(const std::any &arg) const -> std::string;
+    auto appendToBuffer(const LogRecord& record, std::string& buffer) -> void;
 
-    /**
-     * @brief Formats a message using the given format string and arguments.
-     * @param format_string The format string.
-     * @param args The vector of arguments as std::any.
-     * @return The formatted string.
-     */
-    [[nodiscard]] auto formatMessage(std::string_view format_string, const std::vector<std::any> &args) const -> std::string;
-
-    static std::ofstream logFile_;                    ///< The output file stream for writing logs.
-    LFQueue<LogElement> logQueue_;             ///< The lock-free queue for storing log messages.
+    std::array<std::unique_ptr<ThreadLogRing>, MAX_LOG_THREADS> rings_{}; ///< Rings registered by logging threads.
+    std::atomic<std::size_t> nRings_{0};       ///< Number of entries of rings_ in use.
+    std::mutex registerRingMutex_;             ///< Serializes ring registrations.
+    std::atomic<std::uint64_t> nUnregisteredDropped_{0}; ///< Messages dropped for lack of a ring.
+    std::atomic<std::uint64_t> nDiscarded_{0}; ///< Messages discarded unformatted by the logger thread.
+    std::uint64_t nReportedDropped_{0};        ///< Lost messages already reported in the log file.
+    std::uint64_t fileGenerationStarted_{0};   ///< Value of fileGeneration_ when the current file was started.
+    bool isBinaryFile_{false};                 ///< Whether the current file is in LogFileFormat::BINARY.
+    std::bitset<MAX_LOG_FORMATS> isFormatWritten_; ///< Format strings already in the current binary file.
+    inline static std::atomic<LogFileFormat> fileFormat_{LogFileFormat::TEXT}; ///< Format of the last file set.
+    inline static std::atomic<std::uint64_t> fileGeneration_{0}; ///< Number of setLogFile() calls.
+    inline static std::atomic<LogOverflowPolicy> overflowPolicy_{LogOverflowPolicy::DROP_NEWEST}; ///< Policy for full rings.
+    inline static std::atomic<WaitStrategy> waitStrategy_{WaitStrategy::SPIN_PARK}; ///< Wait strategy of the logger thread.
+    inline static thread_local ThreadLogRing* threadRing_{nullptr}; ///< Ring of the calling thread.
     std::unique_ptr<std::jthread> logThread_;  ///< The thread responsible for processing the log queue.
     std::atomic<bool> running_{true};          ///< Flag indicating whether the logger is running.
-    std::vector<std::any> argVector_;          ///< Temporary vector for storing arguments during logging.
-    static std::mutex setLogFileMutex_;          ///< Mutex to ensure thread safety when setting the log file.
+    std::atomic<bool> isPauseRequested_{false}; ///< Set by pauseDraining(), cleared by resumeDraining().
+    std::atomic<bool> isPaused_{false};        ///< Whether the logger thread is held by pauseDraining().
+    inline static std::atomic<LogLevel> minLevel_{LOG_COMPILE_TIME_MIN_LEVEL}; ///< Lowest level logged at runtime.
 };
 
 } // namespace lib
 
+/**
+ * @def LOG_AT_LEVEL(level, msg, ...)
+ * @brief Logs a message at the given level, registering the format string once per call site.
+ *
+ * Compiled out when the level is below LOG_MIN_LEVEL. Otherwise the runtime level is checked
+ * first, so the arguments of a disabled message are never evaluated.
+ *
+ * @param level The utils::LogLevel of the message, a constant expression.
+ * @param msg The format string literal for the log message.
+ * @param ... The arguments to be formatted into the log message.
+ */
+#define LOG_AT_LEVEL(level, msg, ...)                                                      \
+    do {                                                                                   \
+        if constexpr ((level) >= utils::LOG_COMPILE_TIME_MIN_LEVEL) {                      \
+            if (utils::Logger::isLevelEnabled(level)) {                                    \
+                static const auto logFormatId = utils::registerLogFormat(msg);             \
+                utils::Logger::getInstance().log(level, logFormatId, ##__VA_ARGS__);       \
+            }                                                                              \
+        }                                                                                  \
+    } while (false)
+
 /**
  * @def LOG_INFO(msg, ...)
  * @brief Macro for logging an INFO level message.
  * @param msg The format string for the log message.
  * @param ... The arguments to be formatted into the log message.
  */
-#define LOG_INFO(msg, ...) utils::Logger::getInstance().log(utils::LogLevel::INFO, msg, ##__VA_ARGS__)
+#define LOG_INFO(msg, ...) LOG_AT_LEVEL(utils::LogLevel::INFO, msg, ##__VA_ARGS__)
 
 /**
  * @def LOG_DEBUG(msg, ...)
@@ -156,7 +357,7 @@ class Logger {
  * @param msg The format string for the log message.
  * @param ... The arguments to be formatted into the log message.
  */
-#define LOG_DEBUG(msg, ...) utils::Logger::getInstance().log(utils::LogLevel::DEBUG, msg, ##__VA_ARGS__)
+#define LOG_DEBUG(msg, ...) LOG_AT_LEVEL(utils::LogLevel::DEBUG, msg, ##__VA_ARGS__)
 
 /**
  * @def LOG_WARNING(msg, ...)
@@ -164,7 +365,7 @@ class Logger {
  * @param msg The format string for the log message.
  * @param ... The arguments to be formatted into the log message.
  */
-#define LOG_WARNING(msg, ...) utils::Logger::getInstance().log(utils::LogLevel::WARNING, msg, ##__VA_ARGS__)
+#define LOG_WARNING(msg, ...) LOG_AT_LEVEL(utils::LogLevel::WARNING, msg, ##__VA_ARGS__)
 
 /**
  * @def LOG_ERROR(msg, ...)
@@ -172,6 +373,6 @@ class Logger {
  * @param msg The format string for the log message.
  * @param ... The arguments to be formatted into the log message.
  */
-#define LOG_ERROR(msg, ...) utils::Logger::getInstance().log(utils::LogLevel::ERROR, msg, ##__VA_ARGS__)
+#define LOG_ERROR(msg, ...) LOG_AT_LEVEL(utils::LogLevel::ERROR, msg, ##__VA_ARGS__)
 
 #endif // LOW_LATENCY_TRADING_APP_LOGGER_H
\ No newline at end of file
@@ -3,10 +3,26 @@
 
 #include <vector>
 #include <cstddef>
+#include <limits>
+#include <memory>
 #include <type_traits>
 #include <new>
 #include "assertion.h" // Make sure this header is available in your project
 
+/**
+ * @def MEMORY_POOL_DEBUG
+ * @brief Enables the per-block in-use tracking of MemoryPool and its double allocation/free assertions.
+ *
+ * Defaults to on unless NDEBUG is defined. Define it to 0 or 1 to override.
+ */
+#ifndef MEMORY_POOL_DEBUG
+#ifdef NDEBUG
+#define MEMORY_POOL_DEBUG 0
+#else
+#define MEMORY_POOL_DEBUG 1
+#endif
+#endif
+
 namespace utils {
 
 /**
@@ -17,9 +33,14 @@ namespace utils {
  * for objects of type T. It allows for fast allocation and deallocation of objects without the overhead
  * of dynamic memory allocation.
  *
+ * Free blocks form an intrusive singly-linked list: a free block stores the index of the next free
+ * block in its own storage, so both allocate() and deallocate() are O(1) no matter how fragmented
+ * the pool is. Freed blocks are reused in LIFO order, which keeps recently touched memory hot.
+ *
  * @tparam T The type of objects to be stored in the memory pool.
+ * @tparam Allocator Allocator for the block storage (e.g. HugePageAllocator), rebound to the block type.
  */
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 class MemoryPool {
   public:
     /**
@@ -28,9 +49,16 @@ class MemoryPool {
      * @param size The number of memory blocks to pre-allocate.
      */
     explicit MemoryPool(std::size_t size) noexcept
-        : memoryBlocks_(size), freeBlocksCount_(size), lastFreedIndex_(0) {
+        : memoryBlocks_(size), freeBlocksCount_(size) {
         ASSERT_CONDITION(reinterpret_cast<const MemoryBlock *>(&(memoryBlocks_[0].storage)) == &(memoryBlocks_[0]),
                          "Storage should be first member of MemoryBlock.");
+        for (std::size_t i = 0; i < size; ++i) {
+            memoryBlocks_[i].nextFree = i + 1;
+        }
+        if (size > 0) {
+            memoryBlocks_[size - 1].nextFree = NO_FREE_BLOCK;
+        }
+        nextFreeIndex_ = size > 0 ? 0 : NO_FREE_BLOCK;
     }
 
     // Deleted copy and move constructors and assignment operators
@@ -49,21 +77,20 @@ class MemoryPool {
      */
     template<typename... Args>
     T *allocate(Args &&...args) noexcept {
-        if (freeBlocksCount_ == 0) {
+        if (nextFreeIndex_ == NO_FREE_BLOCK) [[unlikely]] {
             return nullptr;
         }
 
         auto memoryBlock = &(memoryBlocks_[nextFreeIndex_]);
+#if MEMORY_POOL_DEBUG
         ASSERT_CONDITION(memoryBlock->isFree, "Expected free MemoryBlock at index:{}", std::to_string(nextFreeIndex_));
-
-        auto *ret = reinterpret_cast<T*>(&(memoryBlock->storage));
-        new (ret) T(std::forward<Args>(args)...); // placement new
         memoryBlock->isFree = false;
+#endif
+        nextFreeIndex_ = memoryBlock->nextFree; // pop the head of the free list before the storage is overwritten
         --freeBlocksCount_;
 
-        if (freeBlocksCount_ > 0) {
-            updateNextFreeIndex();
-        }
+        auto *ret = reinterpret_cast<T*>(&(memoryBlock->storage));
+        new (ret) T(std::forward<Args>(args)...); // placement new
         return ret;
     }
 
@@ -73,18 +100,19 @@ class MemoryPool {
      * @param elem A pointer to the object to deallocate.
      */
     auto deallocate(T* elem) noexcept -> void {
-        const auto * elemPtr = reinterpret_cast<const MemoryBlock*>(elem);
-        auto elemIndex = static_cast<std::size_t>(elemPtr - &(memoryBlocks_[0]));
+        auto * memoryBlock = reinterpret_cast<MemoryBlock*>(elem);
+        auto elemIndex = static_cast<std::size_t>(memoryBlock - &(memoryBlocks_[0]));
 
+#if MEMORY_POOL_DEBUG
         ASSERT_CONDITION(elemIndex < memoryBlocks_.size(), "Invalid element index.");
-        ASSERT_CONDITION(!memoryBlocks_[elemIndex].isFree, "Expected in-use MemoryBlock at index:{}", std::to_string(elemIndex));
+        ASSERT_CONDITION(!memoryBlock->isFree, "Expected in-use MemoryBlock at index:{}", std::to_string(elemIndex));
+        memoryBlock->isFree = true;
+#endif
 
         elem->~T(); // Call destructor
-        memoryBlocks_[elemIndex].isFree = true;
+        memoryBlock->nextFree = nextFreeIndex_; // push onto the head of the free list
+        nextFreeIndex_ = elemIndex;
         ++freeBlocksCount_;
-
-        lastFreedIndex_ = elemIndex;
-        nextFreeIndex_ = lastFreedIndex_; // Set nextFreeIndex_ to the most recently freed block
     }
 
     /**
@@ -106,46 +134,32 @@ class MemoryPool {
     }
 
   private:
-    /**
-     * @brief Updates the index of the next free memory block.
-     *
-     * This method searches for the next free block in the pool, starting from the current
-     * nextFreeIndex_ and wrapping around if necessary. If no free block is found, it triggers
-     * an assertion failure.
-     */
-    auto updateNextFreeIndex() noexcept -> void {
-        if (memoryBlocks_[nextFreeIndex_].isFree) {
-            return; // Current index is already free, no need to update
-        }
-
-        std::size_t startIndex = nextFreeIndex_;
-        do {
-            nextFreeIndex_ = (nextFreeIndex_ + 1) % memoryBlocks_.size();
-            if (memoryBlocks_[nextFreeIndex_].isFree) {
-                return;
-            }
-        } while (nextFreeIndex_ != startIndex);
-
-        // If we've gone through all blocks and none are free
-        ASSERT_CONDITION(false, "No free blocks found in Memory Pool.");
-    }
+    /// Free list terminator
+    static constexpr std::size_t NO_FREE_BLOCK = std::numeric_limits<std::size_t>::max();
 
     /**
      * @struct MemoryBlock
      * @brief Represents a single block of memory in the pool.
      *
-     * Each MemoryBlock contains storage for an object of type T and a flag indicating
+     * Each MemoryBlock contains storage for an object of type T, reused to hold the index of the
+     * next free block while the block is free. In debug mode it also carries a flag indicating
      * whether the block is currently free or in use.
      */
     struct MemoryBlock {
-        std::aligned_storage_t<sizeof(T), alignof(T)> storage; ///< Storage for an object of type T.
+        union {
+            std::aligned_storage_t<sizeof(T), alignof(T)> storage; ///< Storage for an object of type T.
+            std::size_t nextFree; ///< Index of the next free block while this block is free.
+        };
+#if MEMORY_POOL_DEBUG
         bool isFree = true; ///< Indicates whether this block is currently free.
+#endif
     };
 
-    std::vector<MemoryBlock> memoryBlocks_; ///< The pre-allocated memory blocks.
-    std::size_t nextFreeIndex_{0}; ///< Index of the next free memory block.
+    using BlockAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<MemoryBlock>;
+
+    std::vector<MemoryBlock, BlockAllocator> memoryBlocks_; ///< The pre-allocated memory blocks.
+    std::size_t nextFreeIndex_{NO_FREE_BLOCK}; ///< Head of the free list.
     std::size_t freeBlocksCount_; ///< Number of free blocks in the pool.
-    std::size_t lastFreedIndex_; ///< Index of the most recently freed block.
 };
 
 } // namespace utils
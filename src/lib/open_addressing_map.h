@@ -0,0 +1,212 @@
+#ifndef LOW_LATENCY_TRADING_APP_OPEN_ADDRESSING_MAP_H
+#define LOW_LATENCY_TRADING_APP_OPEN_ADDRESSING_MAP_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+/**
+ * @brief Mixes the bits of a 64-bit integer (splitmix64 finalizer).
+ * @details Identity hashes cluster badly under linear probing when keys are sequential ids or
+ * prices, so every key is passed through this finalizer before being reduced to a slot.
+ */
+[[nodiscard]] constexpr auto mixHash(std::uint64_t value) noexcept -> std::uint64_t {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+/**
+ * @brief Default hasher for integral keys of an OpenAddressingMap.
+ */
+struct IntegerHash {
+    template <typename T>
+    [[nodiscard]] constexpr auto operator()(T value) const noexcept -> std::uint64_t {
+        return mixHash(static_cast<std::uint64_t>(value));
+    }
+};
+
+/**
+ * @class OpenAddressingMap
+ * @brief A fixed-capacity hash map using Robin Hood linear probing and backward-shift deletion.
+ *
+ * All storage is allocated once at construction, so insert, find and erase never allocate.
+ * Robin Hood ordering keeps probe sequences short and lets lookups of missing keys stop as
+ * soon as they reach an entry closer to its home slot than the key being searched for.
+ * Deletion shifts the following entries back instead of leaving tombstones, so the table
+ * never degrades under churn.
+ *
+ * @tparam Key The key type, must be equality comparable and cheap to copy.
+ * @tparam Value The mapped type, must be default constructible and cheap to copy.
+ * @tparam Hash The hasher, returning a well mixed 64-bit value.
+ */
+template <typename Key, typename Value, typename Hash = IntegerHash>
+class OpenAddressingMap {
+  public:
+    /**
+     * @brief Constructs a map able to hold up to maxEntries keys.
+     * @details The table is sized to the next power of two holding maxEntries at a load factor of
+     * at most one half, which keeps the expected probe length close to one.
+     * @param maxEntries The maximum number of keys that will be live at the same time.
+     */
+    explicit OpenAddressingMap(std::size_t maxEntries)
+        : slots_(std::bit_ceil(std::max<std::size_t>(2 * maxEntries, 2))), mask_(slots_.size() - 1), maxEntries_(maxEntries) {}
+
+    OpenAddressingMap() = delete;
+    OpenAddressingMap(const OpenAddressingMap &) = delete;
+    OpenAddressingMap(OpenAddressingMap &&) = delete;
+    OpenAddressingMap &operator=(const OpenAddressingMap &) = delete;
+    OpenAddressingMap &operator=(OpenAddressingMap &&) = delete;
+
+    /**
+     * @brief Finds the value mapped to a key.
+     * @param key The key to look up.
+     * @return A pointer to the mapped value, or nullptr if the key is absent.
+     */
+    [[nodiscard]] auto find(const Key &key) noexcept -> Value * {
+        return const_cast<Value *>(std::as_const(*this).find(key));
+    }
+
+    /**
+     * @brief Finds the value mapped to a key.
+     * @param key The key to look up.
+     * @return A pointer to the mapped value, or nullptr if the key is absent.
+     */
+    [[nodiscard]] auto find(const Key &key) const noexcept -> const Value * {
+        auto index = homeSlot(key);
+        for (std::uint32_t distance = 1;; ++distance, index = (index + 1) & mask_) {
+            const auto &slot = slots_[index];
+            if (slot.distance < distance) {
+                return nullptr;
+            }
+            if (slot.distance == distance && slot.key == key) {
+                return &slot.value;
+            }
+        }
+    }
+
+    /**
+     * @brief Inserts a key or overwrites the value of an existing key.
+     * @param key The key to insert.
+     * @param value The value to map to the key.
+     * @return False if the key is new and the map already holds maxEntries keys.
+     */
+    auto insert(const Key &key, const Value &value) noexcept -> bool {
+        if (auto existing = find(key)) {
+            *existing = value;
+            return true;
+        }
+        if (size_ >= maxEntries_) [[unlikely]] {
+            return false;
+        }
+
+        Slot entry{key, value, 1};
+        for (auto index = homeSlot(key);; index = (index + 1) & mask_, ++entry.distance) {
+            auto &slot = slots_[index];
+            if (slot.distance == 0) {
+                slot = entry;
+                ++size_;
+                return true;
+            }
+            // Robin Hood: the entry further from its home slot takes the place
+            if (slot.distance < entry.distance) {
+                std::swap(slot, entry);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes a key from the map.
+     * @param key The key to remove.
+     * @return True if the key was present.
+     */
+    auto erase(const Key &key) noexcept -> bool {
+        auto index = homeSlot(key);
+        for (std::uint32_t distance = 1;; ++distance, index = (index + 1) & mask_) {
+            const auto &slot = slots_[index];
+            if (slot.distance < distance) {
+                return false;
+            }
+            if (slot.distance == distance && slot.key == key) {
+                break;
+            }
+        }
+
+        // Shift the following displaced entries one slot back towards their home
+        for (auto next = (index + 1) & mask_; slots_[next].distance > 1; index = next, next = (next + 1) & mask_) {
+            slots_[index] = slots_[next];
+            --slots_[index].distance;
+        }
+        slots_[index] = Slot{};
+        --size_;
+        return true;
+    }
+
+    /**
+     * @brief Removes every key from the map.
+     */
+    auto clear() noexcept -> void {
+        std::fill(slots_.begin(), slots_.end(), Slot{});
+        size_ = 0;
+    }
+
+    /**
+     * @brief Calls a function with every key and value in the map, in table order.
+     * @param func The function to invoke as func(const Key&, Value&).
+     */
+    template <typename Func>
+    auto forEach(Func &&func) noexcept -> void {
+        for (auto &slot : slots_) {
+            if (slot.distance != 0) {
+                func(std::as_const(slot.key), slot.value);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of keys in the map.
+     */
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+
+    /**
+     * @brief Checks whether the map holds no keys.
+     */
+    [[nodiscard]] auto empty() const noexcept -> bool { return size_ == 0; }
+
+    /**
+     * @brief Returns the number of slots in the underlying table.
+     */
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t { return slots_.size(); }
+
+  private:
+    /**
+     * @struct Slot
+     * @brief A single table entry.
+     */
+    struct Slot {
+        Key key{};                  ///< The stored key.
+        Value value{};              ///< The value mapped to the key.
+        std::uint32_t distance{0};  ///< One plus the distance from the key's home slot, 0 when the slot is empty.
+    };
+
+    [[nodiscard]] auto homeSlot(const Key &key) const noexcept -> std::size_t {
+        return static_cast<std::size_t>(Hash{}(key)) & mask_;
+    }
+
+    std::vector<Slot> slots_; ///< The open-addressing table, its size is a power of two.
+    std::size_t mask_;        ///< Mask reducing a hash to a slot index.
+    std::size_t maxEntries_;  ///< Maximum number of keys held at the same time.
+    std::size_t size_{0};     ///< Number of keys currently held.
+};
+
+} // namespace utils
+
+#endif // LOW_LATENCY_TRADING_APP_OPEN_ADDRESSING_MAP_H
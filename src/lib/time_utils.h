@@ -5,11 +5,16 @@
 #ifndef LOW_LATENCY_TRADING_APP_TIME_UTILS_H
 #define LOW_LATENCY_TRADING_APP_TIME_UTILS_H
 
+#include <array>
 #include <string>
+#include <string_view>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <ctime>
-#include <iomanip>
-#include <sstream>
+#include <limits>
+
+#include "tsc_clock.h"
 
 
 namespace utils {
@@ -22,28 +27,106 @@ constexpr Nanos MILLIS_TO_SECS = 1000;
 constexpr Nanos NANOS_TO_MILLIS = NANOS_TO_MICROS * MICROS_TO_MILLIS;
 constexpr Nanos NANOS_TO_SECS = NANOS_TO_MILLIS * MILLIS_TO_SECS;
 
+/**
+ * @brief Returns the current time in nanoseconds since the epoch, from the TSC once
+ * TscClock::calibrate() succeeded and from the system clock before.
+ */
 inline auto getCurrentNanos() noexcept -> Nanos {
-    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    return TscClock::now();
 }
 
-inline auto getCurrentTimeStr() -> std::string {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    std::tm tm{};
-    localtime_r(&time, &tm); // Thread-safe version of localtime
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+/**
+ * @brief Returns CLOCK_REALTIME in nanoseconds since the epoch, the clock of the kernel socket
+ * timestamps. Costs a vDSO call, unlike getCurrentNanos().
+ */
+inline auto getRealtimeNanos() noexcept -> Nanos {
+    timespec time{};
+    clock_gettime(CLOCK_REALTIME, &time);
+    return time.tv_sec * NANOS_TO_SECS + time.tv_nsec;
 }
 
+/// @brief Length of a timestamp formatted by TimestampFormatter: "YYYY-MM-DD HH:MM:SS.nnnnnnnnn"
+inline constexpr std::size_t TIMESTAMP_STR_LENGTH = 29;
+
+/**
+ * @class TimestampFormatter
+ * @brief Formats nanosecond timestamps as local time, "YYYY-MM-DD HH:MM:SS.nnnnnnnnn".
+ *
+ * The date and time up to the second are cached: localtime_r() and strftime() only run when a
+ * timestamp falls in a different second than the previous one, otherwise only the nine
+ * sub-second digits are rewritten. Not thread-safe, use one formatter per thread.
+ */
+class TimestampFormatter {
+  public:
+    /**
+     * @brief Formats a timestamp.
+     * @param nanos Nanoseconds since the epoch.
+     * @return The formatted timestamp, valid until the next call.
+     */
+    [[nodiscard]] auto format(Nanos nanos) noexcept -> std::string_view {
+        // Floor division, so times before the epoch keep positive sub-second digits
+        auto second = nanos / NANOS_TO_SECS;
+        auto subSecond = nanos % NANOS_TO_SECS;
+        if (subSecond < 0) {
+            --second;
+            subSecond += NANOS_TO_SECS;
+        }
+        if (second != cachedSecond_) [[unlikely]] {
+            formatSecond(second);
+        }
+
+        // Two digits at a time, from the last one
+        auto value = static_cast<std::uint32_t>(subSecond);
+        auto* digit = buffer_.data() + TIMESTAMP_STR_LENGTH;
+        for (int i = 0; i < 4; ++i) {
+            digit -= 2;
+            const auto pair = DIGIT_PAIRS.data() + 2 * (value % 100);
+            digit[0] = pair[0];
+            digit[1] = pair[1];
+            value /= 100;
+        }
+        *--digit = static_cast<char>('0' + value);
+        return {buffer_.data(), TIMESTAMP_STR_LENGTH};
+    }
+
+  private:
+    /// @brief Position of the '.' separating seconds from their fraction
+    static constexpr std::size_t FRACTION_POSITION = TIMESTAMP_STR_LENGTH - 10;
+
+    /// @brief "00" to "99", the digits of each value below 100
+    static constexpr auto DIGIT_PAIRS = [] {
+        std::array<char, 200> pairs{};
+        for (std::size_t i = 0; i < 100; ++i) {
+            pairs[2 * i] = static_cast<char>('0' + i / 10);
+            pairs[2 * i + 1] = static_cast<char>('0' + i % 10);
+        }
+        return pairs;
+    }();
+
+    auto formatSecond(Nanos second) noexcept -> void {
+        const auto time = static_cast<std::time_t>(second);
+        std::tm tm{};
+        localtime_r(&time, &tm); // Thread-safe version of localtime
+        // strftime() writes a terminating null in place of the '.' restored below
+        std::strftime(buffer_.data(), FRACTION_POSITION + 1, "%Y-%m-%d %H:%M:%S", &tm);
+        buffer_[FRACTION_POSITION] = '.';
+        cachedSecond_ = second;
+    }
+
+    std::array<char, TIMESTAMP_STR_LENGTH> buffer_{}; ///< Last formatted timestamp
+    Nanos cachedSecond_{std::numeric_limits<Nanos>::min()}; ///< Second formatted in buffer_, in seconds since the epoch
+};
+
+/**
+ * @brief Formats a timestamp with a formatter cached per thread, see TimestampFormatter.
+ */
 inline auto convertNanosToTimeStr(Nanos nanos) -> std::string {
-    auto time = std::chrono::system_clock::time_point(std::chrono::nanoseconds(nanos));
-    auto time_t = std::chrono::system_clock::to_time_t(time);
-    std::tm tm{};
-    localtime_r(&time_t, &tm); // Thread-safe version of localtime
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+    thread_local TimestampFormatter formatter;
+    return std::string(formatter.format(nanos));
+}
+
+inline auto getCurrentTimeStr() -> std::string {
+    return convertNanosToTimeStr(getCurrentNanos());
 }
 
 } // namespace lib
@@ -0,0 +1,139 @@
+#include "tsc_clock.h"
+
+#include <cmath>
+#include <ctime>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace utils {
+
+namespace {
+
+/// @brief Readings of the TSC and of the system clocks taken at the same time
+struct ClockSample {
+    std::uint64_t tsc{0};       ///< TSC in the middle of the clock readings
+    std::int64_t monotonic{0};  ///< CLOCK_MONOTONIC_RAW, in nanoseconds
+    std::int64_t realtime{0};   ///< CLOCK_REALTIME, in nanoseconds since the epoch
+};
+
+/// @brief Number of readings a sample is selected from
+constexpr int N_SAMPLE_ATTEMPTS = 8;
+
+std::mutex calibrationMutex;     ///< Serializes calibrations
+ClockSample calibrationStart;    ///< First sample of calibrate(), the base of recalibrate()
+double ticksPerSecond = 0;       ///< Last measured frequency, guarded by calibrationMutex
+
+auto toNanos(const timespec& time) noexcept -> std::int64_t {
+    return static_cast<std::int64_t>(time.tv_sec) * 1'000'000'000 + time.tv_nsec;
+}
+
+/**
+ * @brief Reads the clocks between two TSC readings, keeping the tightest of a few attempts to
+ * leave out interrupted ones.
+ */
+auto sampleClocks() noexcept -> ClockSample {
+    ClockSample best;
+    auto bestWindow = std::numeric_limits<std::uint64_t>::max();
+    for (int i = 0; i < N_SAMPLE_ATTEMPTS; ++i) {
+        timespec monotonic{};
+        timespec realtime{};
+        const auto before = readTscOrdered();
+        clock_gettime(CLOCK_MONOTONIC_RAW, &monotonic);
+        clock_gettime(CLOCK_REALTIME, &realtime);
+        const auto after = readTscOrdered();
+        if (after - before < bestWindow) {
+            bestWindow = after - before;
+            best = {before + (after - before) / 2, toNanos(monotonic), toNanos(realtime)};
+        }
+    }
+    return best;
+}
+
+auto hasInvariantTsc() noexcept -> bool {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    // Advanced power management leaf, EDX bit 8: the TSC rate does not depend on the power state
+    return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1u << 8));
+#elif defined(__aarch64__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Returns the fixed-point nanoseconds per tick between two samples, 0 if they are too close.
+ */
+auto measureNanosPerTick(const ClockSample& start, const ClockSample& end, double& measuredTicksPerSecond) noexcept
+    -> std::uint64_t {
+    if (end.tsc <= start.tsc || end.monotonic <= start.monotonic) {
+        return 0;
+    }
+    const auto nanosPerTick = static_cast<double>(end.monotonic - start.monotonic) / static_cast<double>(end.tsc - start.tsc);
+    measuredTicksPerSecond = 1e9 / nanosPerTick;
+    return static_cast<std::uint64_t>(std::ldexp(nanosPerTick, 32));
+}
+
+} // namespace
+
+auto TscClock::calibrate(std::chrono::milliseconds duration) -> bool {
+    if (!hasInvariantTsc()) {
+        return false;
+    }
+
+    std::scoped_lock lock(calibrationMutex);
+    const auto start = sampleClocks();
+    std::this_thread::sleep_for(duration);
+    const auto end = sampleClocks();
+
+    const auto nanosPerTick = measureNanosPerTick(start, end, ticksPerSecond);
+    if (!nanosPerTick) {
+        return false;
+    }
+    calibrationStart = start;
+    publish(end.tsc, end.realtime, nanosPerTick);
+    return true;
+}
+
+auto TscClock::recalibrate() -> bool {
+    std::scoped_lock lock(calibrationMutex);
+    if (!isCalibrated()) {
+        return false;
+    }
+
+    const auto sample = sampleClocks();
+    const auto nanosPerTick = measureNanosPerTick(calibrationStart, sample, ticksPerSecond);
+    if (!nanosPerTick) {
+        return false;
+    }
+    // Continue from the time the current parameters give, only the rate changes
+    const auto baseTsc = baseTsc_.load(std::memory_order_relaxed);
+    const auto baseNanos = baseNanos_.load(std::memory_order_relaxed) +
+                           scale(sample.tsc - baseTsc, nanosPerTick_.load(std::memory_order_relaxed));
+    publish(sample.tsc, baseNanos, nanosPerTick);
+    return true;
+}
+
+auto TscClock::getTicksPerSecond() -> double {
+    std::scoped_lock lock(calibrationMutex);
+    return isCalibrated() ? ticksPerSecond : 0;
+}
+
+auto TscClock::publish(std::uint64_t baseTsc, std::int64_t baseNanos, std::uint64_t nanosPerTick) noexcept -> void {
+    sequence_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    baseTsc_.store(baseTsc, std::memory_order_relaxed);
+    baseNanos_.store(baseNanos, std::memory_order_relaxed);
+    nanosPerTick_.store(nanosPerTick, std::memory_order_relaxed);
+    sequence_.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace utils
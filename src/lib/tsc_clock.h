@@ -0,0 +1,151 @@
+#ifndef LOW_LATENCY_TRADING_APP_TSC_CLOCK_H
+#define LOW_LATENCY_TRADING_APP_TSC_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @file tsc_clock.h
+ * @brief Wall-clock nanoseconds from the CPU timestamp counter, without a system call.
+ */
+
+namespace utils {
+
+/// @brief Time spent measuring the TSC frequency in TscClock::calibrate()
+inline constexpr std::chrono::milliseconds TSC_CALIBRATION_TIME{20};
+
+/**
+ * @brief Reads the timestamp counter. Not ordered with the surrounding instructions.
+ * @details Falls back to the virtual counter on AArch64 and to the steady clock elsewhere.
+ */
+[[nodiscard]] inline auto readTsc() noexcept -> std::uint64_t {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/**
+ * @brief Reads the timestamp counter once all previous instructions completed (rdtscp), for the
+ * end of a measured section.
+ */
+[[nodiscard]] inline auto readTscOrdered() noexcept -> std::uint64_t {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int processorId;
+    return __rdtscp(&processorId);
+#else
+    return readTsc();
+#endif
+}
+
+/**
+ * @class TscClock
+ * @brief Converts timestamp counter readings to nanoseconds since the epoch.
+ *
+ * calibrate() measures the TSC frequency against CLOCK_MONOTONIC_RAW and anchors the clock to
+ * CLOCK_REALTIME once. now() then costs an rdtsc and a fixed-point multiplication:
+ * nanos = baseNanos + ((tsc - baseTsc) * nanosPerTick) >> 32.
+ *
+ * recalibrate() refines the frequency over the whole time since calibrate() and should be called
+ * periodically (every second or so). It re-anchors at the current conversion, so the clock
+ * stays continuous; it follows the rate of CLOCK_MONOTONIC_RAW, not NTP slewing of the wall
+ * clock. The conversion parameters are published with a sequence lock: now() never blocks.
+ *
+ * Until calibrate() succeeds, or if the CPU has no invariant TSC, now() reads the system clock.
+ */
+class TscClock {
+  public:
+    TscClock() = delete;
+
+    /**
+     * @brief Measures the TSC frequency and anchors the clock to the wall clock. Blocks for
+     * about TSC_CALIBRATION_TIME.
+     * @return False if the CPU has no invariant TSC, now() then keeps reading the system clock.
+     */
+    static auto calibrate(std::chrono::milliseconds duration = TSC_CALIBRATION_TIME) -> bool;
+
+    /**
+     * @brief Refines the TSC frequency without disrupting the clock.
+     * @return False if the clock is not calibrated.
+     */
+    static auto recalibrate() -> bool;
+
+    /**
+     * @brief Returns whether now() uses the TSC.
+     */
+    [[nodiscard]] static auto isCalibrated() noexcept -> bool {
+        return nanosPerTick_.load(std::memory_order_acquire) != 0;
+    }
+
+    /**
+     * @brief Returns the measured TSC frequency, 0 if not calibrated.
+     */
+    [[nodiscard]] static auto getTicksPerSecond() -> double;
+
+    /**
+     * @brief Returns the current time in nanoseconds since the epoch.
+     */
+    [[nodiscard]] static auto now() noexcept -> std::int64_t {
+        std::uint64_t sequence;
+        std::uint64_t tsc;
+        std::uint64_t baseTsc;
+        std::int64_t baseNanos;
+        std::uint64_t nanosPerTick;
+        do {
+            sequence = sequence_.load(std::memory_order_acquire);
+            // Read after the sequence, so the counter is never behind the base of the parameters read
+            tsc = readTsc();
+            baseTsc = baseTsc_.load(std::memory_order_relaxed);
+            baseNanos = baseNanos_.load(std::memory_order_relaxed);
+            nanosPerTick = nanosPerTick_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((sequence & 1) || sequence != sequence_.load(std::memory_order_relaxed));
+
+        if (!nanosPerTick) [[unlikely]] {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+        // A counter slightly behind the base, read on another core, reads as the base
+        return baseNanos + (tsc > baseTsc ? scale(tsc - baseTsc, nanosPerTick) : 0);
+    }
+
+    /**
+     * @brief Converts a number of ticks, such as the difference of two readTsc(), to nanoseconds.
+     * @details Returns 0 if not calibrated.
+     */
+    [[nodiscard]] static auto ticksToNanos(std::uint64_t ticks) noexcept -> std::int64_t {
+        return scale(ticks, nanosPerTick_.load(std::memory_order_relaxed));
+    }
+
+  private:
+    /// @brief Number of fractional bits of nanosPerTick_
+    static constexpr int FIXED_POINT_SHIFT = 32;
+
+    [[nodiscard]] static auto scale(std::uint64_t ticks, std::uint64_t nanosPerTick) noexcept -> std::int64_t {
+        __extension__ using Uint128 = unsigned __int128;
+        return static_cast<std::int64_t>((static_cast<Uint128>(ticks) * nanosPerTick) >> FIXED_POINT_SHIFT);
+    }
+
+    /**
+     * @brief Publishes new conversion parameters to the readers of now().
+     */
+    static auto publish(std::uint64_t baseTsc, std::int64_t baseNanos, std::uint64_t nanosPerTick) noexcept -> void;
+
+    inline static std::atomic<std::uint64_t> sequence_{0};     ///< Odd while the parameters are written
+    inline static std::atomic<std::uint64_t> baseTsc_{0};      ///< TSC at the anchor
+    inline static std::atomic<std::int64_t> baseNanos_{0};     ///< Nanoseconds since the epoch at the anchor
+    inline static std::atomic<std::uint64_t> nanosPerTick_{0}; ///< Nanoseconds per tick, FIXED_POINT_SHIFT fractional bits, 0 until calibrated
+};
+
+} // namespace utils
+
+#endif // LOW_LATENCY_TRADING_APP_TSC_CLOCK_H
@@ -0,0 +1,37 @@
+#include "wait_strategy.h"
+
+#ifdef __linux__
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace utils {
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "The futex word should be a plain 32-bit integer");
+
+auto WaitSignal::wake() noexcept -> void {
+    epoch_.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch_), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+auto WaitSignal::wait(std::uint32_t token, std::chrono::nanoseconds timeout) noexcept -> void {
+#ifdef __linux__
+    // Returns at once if a wake() incremented the epoch since the token was read
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    const timespec relativeTimeout{static_cast<time_t>(seconds.count()), static_cast<long>((timeout - seconds).count())};
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&epoch_), FUTEX_WAIT_PRIVATE, token, &relativeTimeout, nullptr, 0);
+#else
+    // No timed futex here: poll the epoch with short sleeps
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (epoch_.load(std::memory_order_acquire) == token && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::min(timeout, WAIT_MIN_PARK * 50));
+    }
+#endif
+}
+
+} // namespace utils
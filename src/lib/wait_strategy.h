@@ -0,0 +1,213 @@
+#ifndef LOW_LATENCY_TRADING_APP_WAIT_STRATEGY_H
+#define LOW_LATENCY_TRADING_APP_WAIT_STRATEGY_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+
+/**
+ * @file wait_strategy.h
+ * @brief How a polling thread waits when it finds no work.
+ */
+
+namespace utils {
+
+/// @brief Idle polls spent spinning before yielding, with WaitStrategy::SPIN_YIELD and SPIN_PARK
+inline constexpr std::uint32_t WAIT_SPIN_LIMIT = 1024;
+/// @brief Idle polls spent yielding before parking, with WaitStrategy::SPIN_PARK
+inline constexpr std::uint32_t WAIT_YIELD_LIMIT = 64;
+/// @brief First sleep of a park without a WaitSignal, doubled up to the maximum park time
+inline constexpr std::chrono::nanoseconds WAIT_MIN_PARK{1000};
+/// @brief Default longest park, how late a wake-up that is never signalled is noticed
+inline constexpr std::chrono::nanoseconds WAIT_MAX_PARK{1'000'000};
+
+/**
+ * @brief What a polling thread does between two polls that found no work.
+ *
+ * The strategies trade wake-up latency for CPU: the spinning ones keep a core busy and notice
+ * new work within a poll, the parking one frees the core and takes a system call to wake up.
+ */
+enum class WaitStrategy : std::uint8_t {
+    BUSY_SPIN,  ///< Polls again at once. Lowest latency, burns the core and its hyperthread sibling.
+    SPIN_PAUSE, ///< Pauses the core between polls, leaving the pipeline to the hyperthread sibling.
+    SPIN_YIELD, ///< Pauses for WAIT_SPIN_LIMIT polls, then yields to the other threads of the core.
+    SPIN_PARK   ///< Like SPIN_YIELD for WAIT_YIELD_LIMIT more polls, then sleeps until a WaitSignal or a timeout.
+};
+
+/**
+ * @brief Converts a WaitStrategy to its name.
+ */
+[[nodiscard]] inline auto waitStrategyToStr(WaitStrategy strategy) noexcept -> std::string_view {
+    switch (strategy) {
+    case WaitStrategy::BUSY_SPIN: return "BUSY_SPIN";
+    case WaitStrategy::SPIN_PAUSE: return "SPIN_PAUSE";
+    case WaitStrategy::SPIN_YIELD: return "SPIN_YIELD";
+    case WaitStrategy::SPIN_PARK: return "SPIN_PARK";
+    }
+    return "UNKNOWN";
+}
+
+/**
+ * @brief Hints the core that the thread is spinning.
+ */
+inline auto cpuRelax() noexcept -> void {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * @class WaitSignal
+ * @brief Wakes a thread parked by a Waiter when its producers publish new work.
+ *
+ * The waiting thread announces itself with prepareWait(), checks once more for work and only
+ * then calls wait(); producers call notify() after publishing. Both sides put a full fence
+ * between their write and their read, so either the waiter sees the new work or the producer
+ * sees the waiter: a wake-up is never lost. Parks are also bounded by a timeout.
+ *
+ * notify() costs a fence and a load of a line only written when the waiter parks, it makes the
+ * system call only when a thread actually waits. One thread may wait at a time, any number may
+ * notify.
+ */
+class WaitSignal {
+  public:
+    WaitSignal() noexcept = default;
+
+    WaitSignal(const WaitSignal&) = delete;
+    WaitSignal(WaitSignal&&) = delete;
+    WaitSignal& operator=(const WaitSignal&) = delete;
+    WaitSignal& operator=(WaitSignal&&) = delete;
+
+    /**
+     * @brief Wakes the waiting thread, if any, after new work was published. Producer side.
+     */
+    auto notify() noexcept -> void {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (isWaiting_.load(std::memory_order_relaxed)) [[unlikely]] {
+            wake();
+        }
+    }
+
+    /**
+     * @brief Wakes the waiting thread, if any, e.g. to stop it.
+     */
+    auto wake() noexcept -> void;
+
+    /**
+     * @brief Announces that the calling thread is about to wait. Check for work after it.
+     * @return The token to pass to wait().
+     */
+    [[nodiscard]] auto prepareWait() noexcept -> std::uint32_t {
+        isWaiting_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return epoch_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sleeps until notified since prepareWait() returned the token, or at most timeout.
+     * @details May also return early on a spurious wake-up.
+     */
+    auto wait(std::uint32_t token, std::chrono::nanoseconds timeout) noexcept -> void;
+
+    /**
+     * @brief Ends the wait announced by prepareWait().
+     */
+    auto cancelWait() noexcept -> void {
+        isWaiting_.store(false, std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<std::uint32_t> epoch_{0};   ///< Incremented by each wake-up, the futex word
+    std::atomic<bool> isWaiting_{false};    ///< Whether a thread is between prepareWait() and cancelWait()
+};
+
+/**
+ * @class Waiter
+ * @brief Applies a WaitStrategy in the loop of a polling thread.
+ *
+ * The loop calls idle() after each poll that found no work and reset() after each one that did:
+ *
+ *     Waiter waiter(strategy, &signal);
+ *     while (isRunning) {
+ *         if (poll()) { waiter.reset(); } else { waiter.idle([&] { return hasWork(); }); }
+ *     }
+ *
+ * With WaitStrategy::SPIN_PARK and a WaitSignal, the thread sleeps until a producer notifies the
+ * signal or maxPark elapses. Without a signal it sleeps for a time doubling from WAIT_MIN_PARK
+ * up to maxPark, for consumers whose producers should not pay for notify().
+ */
+class Waiter {
+  public:
+    /**
+     * @brief Constructs a waiter for one polling thread.
+     * @param strategy What to do when idle.
+     * @param signal Notified by the producers of the polled work, nullptr if they do not.
+     * @param maxPark Longest park, how late unsignalled work may be noticed.
+     */
+    explicit Waiter(WaitStrategy strategy, WaitSignal* signal = nullptr, std::chrono::nanoseconds maxPark = WAIT_MAX_PARK) noexcept
+        : strategy_(strategy), signal_(signal), maxPark_(maxPark) {}
+
+    /**
+     * @brief Restarts the spinning phase, after a poll that found work.
+     */
+    auto reset() noexcept -> void {
+        nIdle_ = 0;
+        parkTime_ = WAIT_MIN_PARK;
+    }
+
+    /**
+     * @brief Waits after a poll that found no work.
+     * @param hasWork Checks whether work arrived, called before parking on the signal.
+     */
+    template <typename HasWork>
+    auto idle(HasWork&& hasWork) noexcept -> void {
+        switch (strategy_) {
+        case WaitStrategy::BUSY_SPIN: return;
+        case WaitStrategy::SPIN_PAUSE: cpuRelax(); return;
+        case WaitStrategy::SPIN_YIELD:
+        case WaitStrategy::SPIN_PARK: break;
+        }
+
+        if (nIdle_ < WAIT_SPIN_LIMIT) {
+            ++nIdle_;
+            cpuRelax();
+        } else if (strategy_ == WaitStrategy::SPIN_YIELD) {
+            std::this_thread::yield();
+        } else if (nIdle_ < WAIT_SPIN_LIMIT + WAIT_YIELD_LIMIT) {
+            ++nIdle_;
+            std::this_thread::yield();
+        } else if (signal_) {
+            const auto token = signal_->prepareWait();
+            if (!hasWork()) {
+                signal_->wait(token, maxPark_);
+            }
+            signal_->cancelWait();
+        } else {
+            std::this_thread::sleep_for(parkTime_);
+            parkTime_ = std::min(parkTime_ * 2, maxPark_);
+        }
+    }
+
+    /**
+     * @brief Returns the strategy applied.
+     */
+    [[nodiscard]] auto getStrategy() const noexcept -> WaitStrategy {
+        return strategy_;
+    }
+
+  private:
+    WaitStrategy strategy_;
+    WaitSignal* signal_;
+    std::chrono::nanoseconds maxPark_;
+    std::uint32_t nIdle_{0};                      ///< Idle polls since the last reset(), up to the parking phase
+    std::chrono::nanoseconds parkTime_{WAIT_MIN_PARK}; ///< Next sleep of an unsignalled park
+};
+
+} // namespace utils
+
+#endif // LOW_LATENCY_TRADING_APP_WAIT_STRATEGY_H
@@ -0,0 +1,367 @@
+/**
+ * @file log_decode.cpp
+ * @brief Renders binary log files (LogFileFormat::BINARY) as the lines the logger writes in text mode.
+ *
+ * Usage: log_decode [options] FILE...
+ *
+ * Files are decoded as a single stream, in the order given: pass rotated files oldest first,
+ * so the format strings written in an earlier file resolve the records of the later ones.
+ * Regular files are memory-mapped, other files (pipes, devices) are read into memory.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lib/log_file.h"
+#include "lib/log_record.h"
+
+namespace {
+
+/// @brief Size of the output buffered before each write to stdout
+constexpr std::size_t OUTPUT_BUFFER_SIZE = 64 * 1024;
+
+constexpr std::string_view USAGE = R"(Usage: log_decode [options] FILE...
+Renders binary log files as text. Rotated files must be given oldest first.
+
+Options:
+  --level LEVEL    only records at LEVEL or above (DEBUG, INFO, WARNING, ERROR)
+  --thread ID      only records of logging thread ID, may be repeated
+  --from TIME      only records at or after TIME
+  --to TIME        only records before TIME
+  --grep TEXT      only records whose message contains TEXT
+  --show-thread    prefix messages with the ID of their logging thread
+  --help           print this help
+
+TIME is either nanoseconds since the epoch or a local time "YYYY-MM-DD HH:MM:SS".
+)";
+
+/**
+ * @struct Filters
+ * @brief Selection of the records to render.
+ */
+struct Filters {
+    utils::LogLevel minLevel{utils::LogLevel::DEBUG};      ///< Lowest level rendered
+    std::vector<std::uint16_t> threadIds;                 ///< Threads rendered, all if empty
+    utils::Nanos from{std::numeric_limits<utils::Nanos>::min()}; ///< First time rendered
+    utils::Nanos to{std::numeric_limits<utils::Nanos>::max()};   ///< End of the time range, excluded
+    std::string substring;                                ///< Text the messages must contain
+    bool showThread{false};                               ///< Whether to print thread IDs
+};
+
+/**
+ * @class InputFile
+ * @brief Read-only view of a file, memory-mapped when possible.
+ */
+class InputFile {
+  public:
+    explicit InputFile(const std::string& path) {
+        const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        struct stat fileStat {};
+        if (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode)) {
+            size_ = static_cast<std::size_t>(fileStat.st_size);
+            isOpen_ = true;
+            if (size_) {
+                map_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (map_ == MAP_FAILED) {
+                    isOpen_ = false;
+                } else {
+                    madvise(map_, size_, MADV_SEQUENTIAL);
+                }
+            }
+        } else {
+            isOpen_ = readAll(fd);
+        }
+        ::close(fd);
+    }
+
+    ~InputFile() {
+        if (map_ != MAP_FAILED) {
+            munmap(map_, size_);
+        }
+    }
+
+    InputFile(const InputFile&) = delete;
+    InputFile(InputFile&&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+    InputFile& operator=(InputFile&&) = delete;
+
+    [[nodiscard]] auto isOpen() const noexcept -> bool {
+        return isOpen_;
+    }
+
+    [[nodiscard]] auto getData() const noexcept -> std::span<const std::byte> {
+        if (map_ != MAP_FAILED) {
+            return {static_cast<const std::byte*>(map_), size_};
+        }
+        return contents_;
+    }
+
+  private:
+    auto readAll(int fd) -> bool {
+        std::byte chunk[OUTPUT_BUFFER_SIZE];
+        while (true) {
+            const auto nRead = ::read(fd, chunk, sizeof(chunk));
+            if (nRead == 0) {
+                return true;
+            }
+            if (nRead < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            contents_.insert(contents_.end(), chunk, chunk + nRead);
+        }
+    }
+
+    void* map_{MAP_FAILED};            ///< Mapping of a regular file
+    std::size_t size_{0};              ///< Size of the mapping
+    std::vector<std::byte> contents_;  ///< Contents of a file that cannot be mapped
+    bool isOpen_{false};               ///< Whether the file could be read
+};
+
+/**
+ * @class LogDecoder
+ * @brief Renders the records of a stream of binary log entries that pass the filters.
+ */
+class LogDecoder {
+  public:
+    explicit LogDecoder(Filters filters) : filters_(std::move(filters)), formats_(utils::MAX_LOG_FORMATS) {
+        output_.reserve(2 * OUTPUT_BUFFER_SIZE);
+    }
+
+    ~LogDecoder() {
+        flush();
+    }
+
+    LogDecoder(const LogDecoder&) = delete;
+    LogDecoder(LogDecoder&&) = delete;
+    LogDecoder& operator=(const LogDecoder&) = delete;
+    LogDecoder& operator=(LogDecoder&&) = delete;
+
+    /**
+     * @brief Decodes the entries at the start of some data.
+     * @return The number of bytes decoded, the rest being the beginning of an incomplete entry,
+     * or nothing if the data is corrupt.
+     */
+    [[nodiscard]] auto decode(std::span<const std::byte> data) -> std::optional<std::size_t> {
+        std::size_t offset = 0;
+        while (true) {
+            std::size_t nBytes = 0;
+            switch (utils::readLogFileEntry(data.subspan(offset), entry_, nBytes)) {
+            case utils::LogFileReadStatus::INCOMPLETE: return offset;
+            case utils::LogFileReadStatus::CORRUPT: corruptOffset_ = offset; return std::nullopt;
+            case utils::LogFileReadStatus::OK: break;
+            }
+            offset += nBytes;
+
+            switch (entry_.type) {
+            case utils::LogFileEntryType::FILE_HEADER: break;
+            case utils::LogFileEntryType::FORMAT: formats_[entry_.formatId].assign(entry_.format); break;
+            case utils::LogFileEntryType::RECORD: render(entry_.record); break;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the offset of the corrupt entry found by the last decode().
+     */
+    [[nodiscard]] auto getCorruptOffset() const noexcept -> std::size_t {
+        return corruptOffset_;
+    }
+
+    /**
+     * @brief Writes the buffered lines to stdout.
+     */
+    auto flush() -> void {
+        std::fwrite(output_.data(), 1, output_.size(), stdout);
+        output_.clear();
+    }
+
+  private:
+    auto render(const utils::LogRecord& record) -> void {
+        const auto& header = record.header;
+        if (header.level < filters_.minLevel || header.timestamp < filters_.from || header.timestamp >= filters_.to) {
+            return;
+        }
+        if (!filters_.threadIds.empty() && std::ranges::find(filters_.threadIds, header.threadId) == filters_.threadIds.end()) {
+            return;
+        }
+
+        message_.clear();
+        const auto& format = formats_[header.formatId];
+        if (format.empty()) {
+            message_.append("<unknown format ").append(std::to_string(header.formatId)).append(">");
+        } else {
+            utils::formatLogMessage(record, format, message_);
+        }
+        if (!filters_.substring.empty() && message_.find(filters_.substring) == std::string::npos) {
+            return;
+        }
+
+        utils::appendLogLinePrefix(header, output_);
+        if (filters_.showThread) {
+            output_.append("[thread ").append(std::to_string(header.threadId)).append("] ");
+        }
+        output_.append(message_).push_back('\n');
+        if (output_.size() >= OUTPUT_BUFFER_SIZE) {
+            flush();
+        }
+    }
+
+    Filters filters_;                  ///< Records to render
+    std::vector<std::string> formats_; ///< Format strings by ID, read from FORMAT entries
+    utils::LogFileEntry entry_{};      ///< Entry being decoded
+    std::string message_;              ///< Message of the record being rendered
+    std::string output_;               ///< Lines not yet written to stdout
+    std::size_t corruptOffset_{0};     ///< Offset of the last corrupt entry found
+};
+
+auto parseLevel(std::string_view name) -> std::optional<utils::LogLevel> {
+    for (const auto level : {utils::LogLevel::DEBUG, utils::LogLevel::INFO, utils::LogLevel::WARNING, utils::LogLevel::ERROR}) {
+        if (utils::logLevelToStr(level) == name) {
+            return level;
+        }
+    }
+    return std::nullopt;
+}
+
+auto parseTime(std::string_view text) -> std::optional<utils::Nanos> {
+    utils::Nanos nanos = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), nanos);
+    if (error == std::errc{} && end == text.data() + text.size()) {
+        return nanos;
+    }
+
+    std::tm tm{};
+    std::istringstream stream{std::string(text)};
+    stream >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    if (stream.fail()) {
+        return std::nullopt;
+    }
+    tm.tm_isdst = -1;
+    return static_cast<utils::Nanos>(std::mktime(&tm)) * utils::NANOS_TO_SECS;
+}
+
+auto parseArguments(std::span<char*> args, Filters& filters, std::vector<std::string>& paths) -> bool {
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        const std::string_view arg = args[i];
+        const auto hasValue = i + 1 < args.size();
+        if (arg == "--help") {
+            std::cout << USAGE;
+            std::exit(EXIT_SUCCESS);
+        } else if (arg == "--show-thread") {
+            filters.showThread = true;
+        } else if (arg == "--level" && hasValue) {
+            const auto level = parseLevel(args[++i]);
+            if (!level) {
+                std::cerr << "Unknown log level: " << args[i] << '\n';
+                return false;
+            }
+            filters.minLevel = *level;
+        } else if (arg == "--thread" && hasValue) {
+            const std::string_view value = args[++i];
+            std::uint16_t threadId = 0;
+            const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), threadId);
+            if (error != std::errc{} || end != value.data() + value.size()) {
+                std::cerr << "Invalid thread ID: " << value << '\n';
+                return false;
+            }
+            filters.threadIds.push_back(threadId);
+        } else if ((arg == "--from" || arg == "--to") && hasValue) {
+            const auto time = parseTime(args[++i]);
+            if (!time) {
+                std::cerr << "Invalid time: " << args[i] << '\n';
+                return false;
+            }
+            (arg == "--from" ? filters.from : filters.to) = *time;
+        } else if (arg == "--grep" && hasValue) {
+            filters.substring = args[++i];
+        } else if (arg.starts_with("--")) {
+            std::cerr << "Unknown or incomplete option: " << arg << '\n';
+            return false;
+        } else {
+            paths.emplace_back(arg);
+        }
+    }
+    return !paths.empty();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Filters filters;
+    std::vector<std::string> paths;
+    if (!parseArguments(std::span(argv + 1, static_cast<std::size_t>(std::max(argc - 1, 0))), filters, paths)) {
+        std::cerr << USAGE;
+        return EXIT_FAILURE;
+    }
+
+    LogDecoder decoder(std::move(filters));
+    // Bytes of an entry straddling two files
+    std::vector<std::byte> carry;
+    for (const auto& path : paths) {
+        const InputFile file(path);
+        if (!file.isOpen()) {
+            std::cerr << "Cannot read " << path << '\n';
+            return EXIT_FAILURE;
+        }
+        auto data = file.getData();
+
+        if (!carry.empty()) {
+            // Complete the pending entry with the head of this file, then resume in the mapping
+            const auto nCarried = carry.size();
+            const auto nHead = std::min(data.size(), utils::MAX_LOG_FILE_ENTRY_SIZE);
+            carry.insert(carry.end(), data.begin(), data.begin() + static_cast<std::ptrdiff_t>(nHead));
+            const auto nDecoded = decoder.decode(carry);
+            if (!nDecoded) {
+                std::cerr << "Corrupt entry at the start of " << path << '\n';
+                return EXIT_FAILURE;
+            }
+            if (*nDecoded < nCarried) {
+                // This file is too short to complete the entry
+                carry.erase(carry.begin(), carry.begin() + static_cast<std::ptrdiff_t>(*nDecoded));
+                carry.insert(carry.end(), data.begin() + static_cast<std::ptrdiff_t>(nHead), data.end());
+                continue;
+            }
+            data = data.subspan(*nDecoded - nCarried);
+            carry.clear();
+        }
+
+        const auto nDecoded = decoder.decode(data);
+        if (!nDecoded) {
+            decoder.flush();
+            std::cerr << "Corrupt entry in " << path << " at offset "
+                      << file.getData().size() - data.size() + decoder.getCorruptOffset() << '\n';
+            return EXIT_FAILURE;
+        }
+        carry.assign(data.begin() + static_cast<std::ptrdiff_t>(*nDecoded), data.end());
+    }
+
+    decoder.flush();
+    if (!carry.empty()) {
+        std::cerr << "Truncated entry at the end of " << paths.back() << '\n';
+    }
+    return EXIT_SUCCESS;
+}
@@ -99,6 +99,25 @@ TEST_F(LFQueueTest, ConcurrentPushPop) {
     EXPECT_EQ(sum.load(), (NUM_OPERATIONS * (NUM_OPERATIONS + 1)) / 2) << "Sum of consumed values should match expected sum";
 }
 
+TEST_F(LFQueueTest, WrapsAroundKeepingCapacity) {
+    SCOPED_TRACE("Testing the ring across many wrap-arounds");
+
+    EXPECT_EQ(queue.capacity(), QUEUE_SIZE) << "Capacity should match the requested size, not the rounded buffer size";
+    int next = 0;
+    for (int round = 0; round < 50; ++round) {
+        for (std::size_t i = 0; i < QUEUE_SIZE; ++i) {
+            ASSERT_TRUE(queue.push(next + static_cast<int>(i)));
+        }
+        EXPECT_FALSE(queue.push(-1)) << "Should fail to push when queue is full in round " << round;
+        for (std::size_t i = 0; i < QUEUE_SIZE; ++i) {
+            auto result = queue.pop();
+            ASSERT_TRUE(result.has_value());
+            EXPECT_EQ(result.value(), next++) << "Elements should come out in FIFO order";
+        }
+    }
+    EXPECT_EQ(queue.size(), 0);
+}
+
 class LFQueueParamTest : public LFQueueTest, public ::testing::WithParamInterface<int> {};
 
 TEST_P(LFQueueParamTest, PushPopMultipleElements) {
@@ -125,3 +144,93 @@ INSTANTIATE_TEST_SUITE_P(
     LFQueueParamTest,
     ::testing::Values(1, 10, 50, 99, 100)
 );
+
+TEST_F(LFQueueTest, ClaimCommitAndPeekConsumeBatches) {
+    SCOPED_TRACE("Testing in-place batch production and consumption");
+
+    auto slots = queue.claim(10);
+    ASSERT_EQ(slots.size(), 10u) << "Should claim the requested number of slots in an empty queue";
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+        slots[i] = static_cast<int>(i);
+    }
+    EXPECT_EQ(queue.size(), 0) << "Claimed slots should not be visible before commit";
+    EXPECT_TRUE(queue.peekBatch(10).empty());
+
+    queue.commit(10);
+    EXPECT_EQ(queue.size(), 10);
+
+    auto batch = queue.peekBatch(4);
+    ASSERT_EQ(batch.size(), 4u);
+    EXPECT_EQ(batch[0], 0);
+    EXPECT_EQ(batch[3], 3);
+    queue.consume(batch.size());
+
+    batch = queue.peekBatch(100);
+    ASSERT_EQ(batch.size(), 6u) << "Should only return the committed elements";
+    EXPECT_EQ(batch[0], 4);
+    queue.consume(batch.size());
+    EXPECT_EQ(queue.size(), 0);
+}
+
+TEST_F(LFQueueTest, BatchesStopAtCapacityAndBufferEnd) {
+    SCOPED_TRACE("Testing batch limits");
+
+    EXPECT_EQ(queue.claim(QUEUE_SIZE + 1).size(), QUEUE_SIZE) << "Should never claim more than the capacity";
+
+    // Move the indices close to the end of the buffer
+    for (std::size_t i = 0; i < QUEUE_SIZE; ++i) {
+        ASSERT_TRUE(queue.push(static_cast<int>(i)));
+    }
+    EXPECT_TRUE(queue.claim(1).empty()) << "Should not claim slots in a full queue";
+    queue.consume(queue.peekBatch(QUEUE_SIZE).size());
+
+    std::size_t total = 0;
+    for (auto slots = queue.claim(QUEUE_SIZE); !slots.empty(); slots = queue.claim(QUEUE_SIZE)) {
+        for (auto& slot : slots) {
+            slot = static_cast<int>(total++);
+        }
+        queue.commit(slots.size());
+    }
+    EXPECT_EQ(total, QUEUE_SIZE) << "Claims split at the end of the buffer should still fill the queue";
+
+    int expected = 0;
+    for (auto batch = queue.peekBatch(QUEUE_SIZE); !batch.empty(); batch = queue.peekBatch(QUEUE_SIZE)) {
+        for (auto value : batch) {
+            EXPECT_EQ(value, expected++);
+        }
+        queue.consume(batch.size());
+    }
+    EXPECT_EQ(expected, static_cast<int>(QUEUE_SIZE));
+}
+
+TEST_F(LFQueueTest, ConcurrentClaimCommitPeekConsume) {
+    SCOPED_TRACE("Testing concurrent batch operations");
+
+    constexpr int NUM_OPERATIONS = 100000;
+    long long sum = 0;
+
+    auto producer = [&]() {
+        int next = 1;
+        while (next <= NUM_OPERATIONS) {
+            auto slots = queue.claim(static_cast<std::size_t>(std::min(7, NUM_OPERATIONS - next + 1)));
+            for (auto& slot : slots) {
+                slot = next++;
+            }
+            queue.commit(slots.size());
+        }
+    };
+
+    std::jthread prod_thread(producer);
+    int expected = 1;
+    while (expected <= NUM_OPERATIONS) {
+        auto batch = queue.peekBatch(13);
+        for (auto value : batch) {
+            ASSERT_EQ(value, expected++) << "Elements should come out in FIFO order";
+            sum += value;
+        }
+        queue.consume(batch.size());
+    }
+    prod_thread.join();
+
+    EXPECT_EQ(sum, static_cast<long long>(NUM_OPERATIONS) * (NUM_OPERATIONS + 1) / 2);
+}
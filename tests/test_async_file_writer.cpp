@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "lib/async_file_writer.h"
+
+using namespace utils;
+
+class AsyncFileWriterTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        directory = std::filesystem::temp_directory_path() /
+                    std::format("async_file_writer_{}", std::chrono::system_clock::now().time_since_epoch().count());
+        std::filesystem::create_directories(directory);
+        path = (directory / "out.log").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+    }
+
+    [[nodiscard]] static std::string readFile(const std::filesystem::path& file) {
+        std::ifstream stream(file, std::ios::binary);
+        return std::string{(std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>()};
+    }
+
+    [[nodiscard]] std::string readAllFiles() const {
+        // Rotated files are named after the time they were rotated, in order
+        std::vector<std::filesystem::path> rotated;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            if (entry.path().string() != path) {
+                rotated.push_back(entry.path());
+            }
+        }
+        std::ranges::sort(rotated);
+        std::string content;
+        for (const auto& file : rotated) {
+            content += readFile(file);
+        }
+        return content + readFile(path);
+    }
+
+    std::filesystem::path directory;
+    std::string path;
+};
+
+TEST_F(AsyncFileWriterTest, WritesFlushedDataAfterSync) {
+    AsyncFileWriter writer;
+    ASSERT_TRUE(writer.open(path)) << "Failed to open " << path;
+
+    writer.append("first line\n");
+    writer.append("second line\n");
+    writer.flush();
+    writer.sync();
+    EXPECT_EQ(readFile(path), "first line\nsecond line\n") << "Flushed data should be in the file after sync()";
+
+    writer.append("unflushed\n");
+    writer.close();
+    EXPECT_EQ(readFile(path), "first line\nsecond line\nunflushed\n") << "close() should write pending data";
+}
+
+TEST_F(AsyncFileWriterTest, AppendsLargerThanTheBuffers) {
+    AsyncFileWriter writer;
+    ASSERT_TRUE(writer.open(path)) << "Failed to open " << path;
+
+    std::string expected;
+    for (int i = 0; expected.size() < 3 * FILE_WRITER_BUFFER_SIZE; ++i) {
+        const auto line = std::format("line {}\n", i);
+        writer.append(line);
+        expected += line;
+    }
+    writer.close();
+    EXPECT_EQ(readFile(path), expected) << "Data spanning several buffers should be written in order";
+}
+
+TEST_F(AsyncFileWriterTest, RotatesBySize) {
+    AsyncFileWriter writer;
+    ASSERT_TRUE(writer.open(path, {.rotateAfterBytes = 64})) << "Failed to open " << path;
+
+    std::string expected;
+    for (int i = 0; i < 10; ++i) {
+        const auto line = std::format("rotated line {:02}\n", i);
+        writer.append(line);
+        writer.flush();
+        writer.sync();
+        expected += line;
+    }
+    writer.close();
+
+    const auto nFiles = std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator{});
+    EXPECT_GT(nFiles, 1) << "The file should have been rotated";
+    EXPECT_LE(std::filesystem::file_size(path), 64u) << "The current file should not exceed the rotation size";
+    EXPECT_EQ(readAllFiles(), expected) << "Rotation should not lose or reorder data";
+}
+
+TEST_F(AsyncFileWriterTest, DirectIOKeepsPartialBlocksUntilClose) {
+    AsyncFileWriter writer;
+    ASSERT_TRUE(writer.open(path, {.preallocateBytes = 1024 * 1024, .useDirectIO = true})) << "Failed to open " << path;
+
+    const std::string block(FILE_WRITER_BLOCK_SIZE, 'x');
+    writer.append(block);
+    writer.append("tail");
+    writer.flush();
+    writer.sync();
+    EXPECT_EQ(readFile(path), block) << "Only whole blocks should be written before close()";
+
+    writer.close();
+    EXPECT_EQ(readFile(path), block + "tail") << "close() should write the partial block";
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <set>
+
+#include "lib/hierarchical_bitmap.h"
+
+class HierarchicalBitmapTest : public ::testing::Test {
+  protected:
+    static constexpr std::size_t BITMAP_SIZE = 64 * 64 * 3 + 17;
+    using Bitmap = utils::HierarchicalBitmap<BITMAP_SIZE>;
+    Bitmap bitmap{};
+};
+
+TEST_F(HierarchicalBitmapTest, InitialStateIsEmpty) {
+    EXPECT_TRUE(bitmap.empty()) << "Bitmap should be empty upon initialization";
+    EXPECT_EQ(bitmap.findFirst(), Bitmap::NPOS);
+    EXPECT_EQ(bitmap.findLast(), Bitmap::NPOS);
+}
+
+TEST_F(HierarchicalBitmapTest, SetAndReset) {
+    bitmap.set(0);
+    bitmap.set(4096);
+    bitmap.set(BITMAP_SIZE - 1);
+
+    EXPECT_TRUE(bitmap.test(0));
+    EXPECT_TRUE(bitmap.test(4096));
+    EXPECT_TRUE(bitmap.test(BITMAP_SIZE - 1));
+    EXPECT_FALSE(bitmap.test(1));
+    EXPECT_FALSE(bitmap.empty());
+
+    bitmap.reset(0);
+    bitmap.reset(4096);
+    bitmap.reset(BITMAP_SIZE - 1);
+    EXPECT_TRUE(bitmap.empty()) << "Bitmap should be empty after clearing every set slot";
+}
+
+TEST_F(HierarchicalBitmapTest, FindAcrossLevels) {
+    bitmap.set(5);
+    bitmap.set(70);
+    bitmap.set(9000);
+
+    EXPECT_EQ(bitmap.findNext(0), 5u);
+    EXPECT_EQ(bitmap.findNext(6), 70u) << "Should skip to the next leaf word";
+    EXPECT_EQ(bitmap.findNext(71), 9000u) << "Should skip to the next middle word";
+    EXPECT_EQ(bitmap.findNext(9001), Bitmap::NPOS);
+
+    EXPECT_EQ(bitmap.findPrev(BITMAP_SIZE), 9000u);
+    EXPECT_EQ(bitmap.findPrev(8999), 70u) << "Should skip back to the previous middle word";
+    EXPECT_EQ(bitmap.findPrev(69), 5u) << "Should skip back to the previous leaf word";
+    EXPECT_EQ(bitmap.findPrev(4), Bitmap::NPOS);
+}
+
+TEST_F(HierarchicalBitmapTest, MatchesReferenceSet) {
+    std::mt19937 rng(42);
+    std::set<std::size_t> reference;
+
+    for (int i = 0; i < 20000; ++i) {
+        const auto index = rng() % BITMAP_SIZE;
+        if (rng() % 2) {
+            bitmap.set(index);
+            reference.insert(index);
+        } else {
+            bitmap.reset(index);
+            reference.erase(index);
+        }
+
+        const auto probe = rng() % BITMAP_SIZE;
+        const auto next = reference.lower_bound(probe);
+        EXPECT_EQ(bitmap.findNext(probe), next == reference.end() ? Bitmap::NPOS : *next) << "findNext mismatch at " << probe;
+
+        const auto prev = reference.upper_bound(probe);
+        EXPECT_EQ(bitmap.findPrev(probe), prev == reference.begin() ? Bitmap::NPOS : *std::prev(prev)) << "findPrev mismatch at " << probe;
+    }
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+#include "lib/huge_page_allocator.h"
+#include "lib/lock_free_queue.h"
+#include "lib/memory_pool.h"
+
+class HugePageAllocatorTest : public ::testing::Test {
+  protected:
+    static constexpr std::size_t N_ELEMENTS = 100000;
+};
+
+TEST_F(HugePageAllocatorTest, VectorStorageIsUsable) {
+    std::vector<std::uint64_t, utils::HugePageAllocator<std::uint64_t>> values(N_ELEMENTS);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(values.data()) % sysconf(_SC_PAGESIZE), 0u)
+        << "Storage should start on a page boundary";
+
+    for (std::size_t i = 0; i < N_ELEMENTS; ++i) {
+        values[i] = i;
+    }
+    for (std::size_t i = 0; i < N_ELEMENTS; ++i) {
+        ASSERT_EQ(values[i], i);
+    }
+}
+
+TEST_F(HugePageAllocatorTest, BacksMemoryPool) {
+    utils::MemoryPool<std::uint64_t, utils::HugePageAllocator<std::uint64_t>> pool{N_ELEMENTS};
+    auto* value = pool.allocate(42u);
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, 42u);
+    pool.deallocate(value);
+    EXPECT_EQ(pool.getFreeBlocksCount(), N_ELEMENTS);
+}
+
+TEST_F(HugePageAllocatorTest, BacksLFQueue) {
+    utils::LFQueue<int, utils::HugePageAllocator<int>> queue{N_ELEMENTS};
+    EXPECT_TRUE(queue.push(7));
+    auto value = queue.pop();
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(*value, 7);
+}
+
+TEST_F(HugePageAllocatorTest, RegionsAreHugePageAligned) {
+    constexpr std::size_t N_BYTES = 3 * utils::HUGE_PAGE_SIZE;
+    auto* region = utils::mapHugePages(N_BYTES);
+    ASSERT_NE(region, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(region) % utils::HUGE_PAGE_SIZE, 0u)
+        << "Regions should start on a huge page boundary, so the kernel can back them with huge pages";
+
+    auto* bytes = static_cast<std::uint8_t*>(region);
+    bytes[0] = 1;
+    bytes[N_BYTES - 1] = 2;
+    EXPECT_EQ(bytes[0] + bytes[N_BYTES - 1], 3);
+    utils::unmapHugePages(region, N_BYTES);
+}
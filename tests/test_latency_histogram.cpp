@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "lib/latency_histogram.h"
+
+using namespace utils;
+
+class LatencyHistogramTest : public ::testing::Test {
+  protected:
+    LatencyHistogram histogram_;
+};
+
+TEST_F(LatencyHistogramTest, BucketsBoundTheRelativeError) {
+    for (std::uint64_t value = 0; value < (std::uint64_t{1} << 36); value = value * 5 / 4 + 1) {
+        const auto index = LatencyHistogram::getBucketIndex(value);
+        ASSERT_LT(index, LatencyHistogram::N_BUCKETS) << "Value " << value << " should have a bucket";
+        const auto upperBound = LatencyHistogram::getBucketUpperBound(index);
+        ASSERT_GE(upperBound, value) << "Bucket " << index << " should contain " << value;
+        ASSERT_LE(upperBound - value, value / 32) << "Bucket " << index << " should be at most 1/32 of " << value << " wide";
+        if (index > 0) {
+            ASSERT_LT(LatencyHistogram::getBucketUpperBound(index - 1), value) << "Value " << value << " should be in the first bucket able to hold it";
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::getBucketIndex(std::uint64_t{1} << 62), LatencyHistogram::N_BUCKETS - 1) << "Out of range values should go to the last bucket";
+}
+
+TEST_F(LatencyHistogramTest, ComputesPercentiles) {
+    EXPECT_EQ(histogram_.getPercentile(50.0), 0u) << "An empty histogram should report 0";
+
+    for (Nanos latency = 1; latency <= 10'000; ++latency) {
+        histogram_.record(latency);
+    }
+    histogram_.record(-5);
+
+    EXPECT_EQ(histogram_.getCount(), 10'001u);
+    EXPECT_EQ(histogram_.getMax(), 10'000u);
+    EXPECT_NEAR(histogram_.getMean(), 5'000.0, 1.0);
+    EXPECT_EQ(histogram_.getPercentile(0.0), 0u) << "Negative latencies should count as 0";
+    EXPECT_EQ(histogram_.getPercentile(100.0), 10'000u) << "The 100th percentile should be the maximum";
+    for (const auto& [percentile, expected] : {std::pair{50.0, 5'000.0}, {90.0, 9'000.0}, {99.0, 9'900.0}, {99.9, 9'990.0}}) {
+        const auto value = static_cast<double>(histogram_.getPercentile(percentile));
+        EXPECT_GE(value, expected - 1.0) << "p" << percentile;
+        EXPECT_LE(value, expected * (1.0 + 1.0 / 32.0)) << "p" << percentile;
+    }
+}
+
+TEST_F(LatencyHistogramTest, MergesHistograms) {
+    LatencyHistogram other;
+    histogram_.record(100);
+    other.record(1'000'000);
+    other.record(200);
+
+    histogram_.merge(other);
+
+    EXPECT_EQ(histogram_.getCount(), 3u);
+    EXPECT_EQ(histogram_.getMax(), 1'000'000u);
+    EXPECT_EQ(histogram_.getPercentile(50.0), LatencyHistogram::getBucketUpperBound(LatencyHistogram::getBucketIndex(200)));
+    EXPECT_EQ(other.getCount(), 2u) << "The merged histogram should be left unchanged";
+}
+
+TEST_F(LatencyHistogramTest, MonitorCollectsAllThreads) {
+    constexpr std::size_t STAGE = MAX_LATENCY_STAGES - 1;
+    constexpr int N_THREADS = 4;
+    constexpr int N_RECORDS = 10'000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < N_THREADS; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < N_RECORDS; ++i) {
+                LatencyMonitor::record(STAGE, (t + 1) * 1'000);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    LatencyMonitor::collect(STAGE, histogram_);
+    EXPECT_EQ(histogram_.getCount(), static_cast<std::uint64_t>(N_THREADS * N_RECORDS)) << "Records of exited threads should be kept";
+    EXPECT_EQ(histogram_.getMax(), static_cast<std::uint64_t>(N_THREADS * 1'000));
+    EXPECT_EQ(histogram_.getPercentile(25.0), LatencyHistogram::getBucketUpperBound(LatencyHistogram::getBucketIndex(1'000)));
+}
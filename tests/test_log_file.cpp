@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <span>
+#include <string>
+
+#include "lib/log_file.h"
+
+using namespace utils;
+
+class LogFileTest : public ::testing::Test {
+  protected:
+    [[nodiscard]] static std::span<const std::byte> asBytes(const std::string& data) {
+        return std::as_bytes(std::span(data.data(), data.size()));
+    }
+
+    std::string data;
+    LogFileEntry entry{};
+    std::size_t nBytes{0};
+};
+
+TEST_F(LogFileTest, RoundTripsEntries) {
+    LogRecord record{};
+    encodeLogRecord(record, LogLevel::ERROR, 12, 456, 7, "text");
+    record.header.threadId = 3;
+
+    appendLogFileHeader(data);
+    appendLogFormatEntry(12, "value {} {}", data);
+    appendLogRecordEntry(record, data);
+    auto bytes = asBytes(data);
+
+    ASSERT_EQ(readLogFileEntry(bytes, entry, nBytes), LogFileReadStatus::OK);
+    EXPECT_EQ(entry.type, LogFileEntryType::FILE_HEADER);
+    bytes = bytes.subspan(nBytes);
+
+    ASSERT_EQ(readLogFileEntry(bytes, entry, nBytes), LogFileReadStatus::OK);
+    EXPECT_EQ(entry.type, LogFileEntryType::FORMAT);
+    EXPECT_EQ(entry.formatId, 12);
+    EXPECT_EQ(entry.format, "value {} {}");
+    bytes = bytes.subspan(nBytes);
+
+    ASSERT_EQ(readLogFileEntry(bytes, entry, nBytes), LogFileReadStatus::OK);
+    EXPECT_EQ(entry.type, LogFileEntryType::RECORD);
+    EXPECT_EQ(nBytes, bytes.size()) << "A record entry should only hold the payload bytes in use";
+    EXPECT_EQ(entry.record.header.timestamp, 456);
+    EXPECT_EQ(entry.record.header.level, LogLevel::ERROR);
+    EXPECT_EQ(entry.record.header.threadId, 3);
+
+    std::string message;
+    formatLogMessage(entry.record, "value {} {}", message);
+    EXPECT_EQ(message, "value 7 text");
+}
+
+TEST_F(LogFileTest, DetectsIncompleteAndCorruptEntries) {
+    LogRecord record{};
+    encodeLogRecord(record, LogLevel::INFO, 1, 1, 42);
+    appendLogRecordEntry(record, data);
+
+    for (std::size_t size = 0; size < data.size(); ++size) {
+        EXPECT_EQ(readLogFileEntry(asBytes(data).first(size), entry, nBytes), LogFileReadStatus::INCOMPLETE)
+            << "A record cut after " << size << " bytes should be incomplete";
+    }
+
+    data[0] = 0x7f;
+    EXPECT_EQ(readLogFileEntry(asBytes(data), entry, nBytes), LogFileReadStatus::CORRUPT) << "Unknown entry types should be rejected";
+
+    data.clear();
+    appendLogFileHeader(data);
+    data.back() = 'X';
+    EXPECT_EQ(readLogFileEntry(asBytes(data), entry, nBytes), LogFileReadStatus::CORRUPT) << "A wrong magic should be rejected";
+}
+
+TEST_F(LogFileTest, FormatsTruncatedPayloadsSafely) {
+    LogRecord record{};
+    encodeLogRecord(record, LogLevel::INFO, 1, 1, "a string argument");
+    record.header.payloadSize = 4;
+
+    std::string message;
+    formatLogMessage(record, "arg: {}", message);
+    EXPECT_EQ(message, "arg: {}") << "An argument past the payload in use should not be read";
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+
+#include "lib/log_record.h"
+
+using namespace utils;
+
+class LogRecordTest : public ::testing::Test {
+  protected:
+    enum class Color : std::uint8_t { RED = 1, BLUE = 2 };
+
+    [[nodiscard]] static std::string format(const LogRecord& record, std::string_view fmt) {
+        std::string out;
+        formatLogMessage(record, fmt, out);
+        return out;
+    }
+
+    LogRecord record{};
+};
+
+TEST_F(LogRecordTest, RoundTripsSupportedTypes) {
+    const std::string owned = "owned";
+    const std::string_view view = "view";
+    encodeLogRecord(record, LogLevel::WARNING, 7, 123, 42, -5L, std::uint32_t{9}, 3.14, 2.5f, true, 'x',
+                    "literal", owned, view, Color::BLUE);
+
+    EXPECT_EQ(record.header.timestamp, 123);
+    EXPECT_EQ(record.header.formatId, 7);
+    EXPECT_EQ(record.header.level, LogLevel::WARNING);
+    EXPECT_EQ(record.header.nArgs, 11);
+    EXPECT_EQ(format(record, "{} {} {} {} {} {} {} {} {} {} {}|{}"),
+              "42 -5 9 3.14 2.5 true x literal owned view 2|{}");
+}
+
+TEST_F(LogRecordTest, KeepsPlaceholdersWithoutArguments) {
+    encodeLogRecord(record, LogLevel::INFO, 0, 0, 1);
+    EXPECT_EQ(format(record, "a {} b {} c"), "a 1 b {} c");
+}
+
+TEST_F(LogRecordTest, TruncatesArgumentsThatDoNotFit) {
+    const std::string longString(2 * LOG_RECORD_SIZE, 'z');
+    encodeLogRecord(record, LogLevel::INFO, 0, 0, longString, 17);
+
+    EXPECT_EQ(record.header.nArgs, 1) << "Arguments after a string filling the payload should be dropped";
+    EXPECT_EQ(record.header.payloadSize, record.payload.size());
+    const auto out = format(record, "{}");
+    EXPECT_EQ(out, std::string(record.payload.size() - 3, 'z')) << "String should be truncated to the payload size";
+}
+
+TEST_F(LogRecordTest, RegistersFormats) {
+    const auto first = registerLogFormat("first {}");
+    const auto second = registerLogFormat("second {}");
+    EXPECT_NE(first, second);
+    EXPECT_EQ(getLogFormat(first), "first {}");
+    EXPECT_EQ(getLogFormat(second), "second {}");
+    EXPECT_GT(getLogFormatCount(), second);
+}
@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <fstream>
 #include <regex>
 #include <thread>
+#include <vector>
 
 #include "lib/logger.h"
 
@@ -70,7 +72,7 @@ TEST_F(LoggerTest, MultipleArguments) {
 
     std::string logContent = readLogFile();
 
-    EXPECT_TRUE(logContent.find("Multiple types: 42 3.140000 true A") != std::string::npos);
+    EXPECT_TRUE(logContent.find("Multiple types: 42 3.14 true A") != std::string::npos);
 }
 
 TEST_F(LoggerTest, SingleProducerLogging) {
@@ -103,8 +105,8 @@ TEST_F(LoggerTest, TimestampFormat) {
 
     std::string logContent = readLogFile();
 
-    // Regex to match ISO 8601 timestamp format
-    std::regex logEntryRegex(R"(\[\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2}\] \[INFO\] Test message\n)");
+    // Regex to match ISO 8601 timestamp format, with nanoseconds
+    std::regex logEntryRegex(R"(\[\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2}\.\d{9}\] \[INFO\] Test message\n)");
 
     EXPECT_TRUE(std::regex_search(logContent, logEntryRegex));
 
@@ -123,3 +125,216 @@ TEST_F(LoggerTest, LargeNumberOfLogs) {
 
     EXPECT_EQ(std::count(logContent.begin(), logContent.end(), '\n'), 3000);
 }
+
+TEST_F(LoggerTest, RuntimeLevelFiltering) {
+    [[maybe_unused]] auto const& logger = Logger::getInstance(logFileName);
+
+    int nEvaluations = 0;
+    auto countedArg = [&nEvaluations]() {
+        ++nEvaluations;
+        return nEvaluations;
+    };
+
+    Logger::setLogLevel(LogLevel::WARNING);
+    EXPECT_FALSE(Logger::isLevelEnabled(LogLevel::INFO));
+    LOG_INFO("Filtered message {}", countedArg());
+    LOG_WARNING("Kept message {}", countedArg());
+    Logger::setLogLevel(LOG_COMPILE_TIME_MIN_LEVEL);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+    std::string logContent = readLogFile();
+
+    EXPECT_EQ(nEvaluations, 1) << "Arguments of a filtered message should not be evaluated";
+    EXPECT_EQ(logContent.find("Filtered message"), std::string::npos);
+    EXPECT_NE(logContent.find("Kept message 1"), std::string::npos);
+}
+
+TEST_F(LoggerTest, MultipleProducerLogging) {
+    [[maybe_unused]] auto const& logger = Logger::getInstance(logFileName);
+
+    constexpr int N_THREADS = 4;
+    constexpr int N_MESSAGES = 250;
+    {
+        std::vector<std::jthread> producers;
+        for (int t = 0; t < N_THREADS; ++t) {
+            producers.emplace_back([t]() {
+                for (int i = 0; i < N_MESSAGES; ++i) {
+                    LOG_INFO("Thread {} message {}", t, i);
+                }
+            });
+        }
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    std::string logContent = readLogFile();
+
+    EXPECT_EQ(std::count(logContent.begin(), logContent.end(), '\n'), N_THREADS * N_MESSAGES);
+    for (int t = 0; t < N_THREADS; ++t) {
+        // Each thread's messages keep their order
+        std::size_t previous = 0;
+        for (int i = 0; i < N_MESSAGES; ++i) {
+            const auto position = logContent.find(std::format("Thread {} message {}\n", t, i));
+            ASSERT_NE(position, std::string::npos) << "Missing message " << i << " of thread " << t;
+            EXPECT_GE(position, previous) << "Message " << i << " of thread " << t << " is out of order";
+            previous = position;
+        }
+    }
+}
+
+TEST_F(LoggerTest, RingsOfExitedThreadsAreReused) {
+    [[maybe_unused]] auto const& logger = Logger::getInstance(logFileName);
+
+    // More short-lived threads than rings
+    constexpr int N_THREADS = 2 * static_cast<int>(MAX_LOG_THREADS);
+    for (int t = 0; t < N_THREADS; ++t) {
+        std::jthread([t]() { LOG_INFO("Short-lived thread {}", t); }).join();
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    std::string logContent = readLogFile();
+
+    EXPECT_EQ(std::count(logContent.begin(), logContent.end(), '\n'), N_THREADS)
+        << "Every thread should have found a ring to log to";
+}
+
+TEST_F(LoggerTest, BlockingOverflowPolicyKeepsEveryMessage) {
+    auto& logger = Logger::getInstance(logFileName);
+
+    // Several times the ring size, far more than the logger thread formats in the meantime
+    constexpr int N_MESSAGES = 3 * static_cast<int>(LOG_RING_SIZE);
+    const auto nDroppedBefore = logger.getDroppedRecordCount();
+
+    Logger::setOverflowPolicy(LogOverflowPolicy::BLOCK);
+    for (int i = 0; i < N_MESSAGES; ++i) {
+        LOG_INFO("Blocking overflow message {}", i);
+    }
+    Logger::setOverflowPolicy(LogOverflowPolicy::DROP_NEWEST);
+
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+
+    std::string logContent = readLogFile();
+
+    EXPECT_EQ(logger.getDroppedRecordCount(), nDroppedBefore) << "No message should be dropped when blocking";
+    EXPECT_EQ(std::count(logContent.begin(), logContent.end(), '\n'), N_MESSAGES);
+    EXPECT_NE(logContent.find(std::format("Blocking overflow message {}\n", N_MESSAGES - 1)), std::string::npos);
+}
+
+TEST_F(LoggerTest, DroppingOverflowPoliciesAreAccounted) {
+    auto& logger = Logger::getInstance(logFileName);
+
+    // Twice what the ring holds, logged while the logger thread is held so the ring surely fills
+    constexpr std::size_t N_MESSAGES = 2 * LOG_RING_SIZE;
+    constexpr std::size_t N_OVERFLOWS = N_MESSAGES - LOG_RING_SIZE;
+    for (const auto policy : {LogOverflowPolicy::DROP_NEWEST, LogOverflowPolicy::DROP_OLDEST}) {
+        const auto nDroppedBefore = logger.getDroppedRecordCount();
+        const auto nOverflowsBefore = logger.getOverflowCount();
+
+        logger.pauseDraining();
+        Logger::setOverflowPolicy(policy);
+        for (std::size_t i = 0; i < N_MESSAGES; ++i) {
+            LOG_INFO("Dropping overflow message {}", i);
+        }
+        Logger::setOverflowPolicy(LogOverflowPolicy::DROP_NEWEST);
+        EXPECT_EQ(logger.getOverflowCount() - nOverflowsBefore, N_OVERFLOWS) << "Every message past a full ring overflows";
+        logger.resumeDraining();
+
+        // Under DROP_OLDEST the logger thread also discards the older half of the full ring
+        const auto isDropOldest = policy == LogOverflowPolicy::DROP_OLDEST;
+        const auto nExpectedDropped = N_OVERFLOWS + (isDropOldest ? LOG_RING_SIZE / 2 : 0);
+        const auto firstWritten = isDropOldest ? LOG_RING_SIZE / 2 : 0;
+
+        std::string logContent;
+        std::size_t nWritten = 0;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while ((nWritten != N_MESSAGES - nExpectedDropped || logContent.find("Logger dropped") == std::string::npos) &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            logContent = readLogFile();
+            nWritten = 0;
+            for (auto pos = logContent.find("Dropping overflow message"); pos != std::string::npos;
+                 pos = logContent.find("Dropping overflow message", pos + 1)) {
+                ++nWritten;
+            }
+        }
+
+        EXPECT_EQ(logger.getDroppedRecordCount() - nDroppedBefore, nExpectedDropped);
+        EXPECT_EQ(nWritten, N_MESSAGES - nExpectedDropped) << "Every message should be written or counted as dropped";
+        EXPECT_NE(logContent.find(std::format("Dropping overflow message {}\n", firstWritten)), std::string::npos);
+        EXPECT_EQ(logContent.find(std::format("Dropping overflow message {}\n", LOG_RING_SIZE)), std::string::npos)
+            << "Messages logged into the full ring should be dropped";
+        EXPECT_NE(logContent.find("Logger dropped"), std::string::npos) << "Drops should be reported in the log file";
+
+        std::ofstream(logFileName, std::ios::trunc).close();
+    }
+}
+
+TEST_F(LoggerTest, BinaryFileFormat) {
+    [[maybe_unused]] auto const& logger = Logger::getInstance(logFileName);
+    Logger::setLogFile(logFileName, {}, LogFileFormat::BINARY);
+
+    for (int i = 42; i < 44; ++i) {
+        LOG_INFO("Binary message: {} {}", i, "text");
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    // Later tests expect text files
+    Logger::setLogFile(logFileName);
+
+    const auto logContent = readLogFile();
+    auto data = std::as_bytes(std::span(logContent.data(), logContent.size()));
+    std::vector<std::string> messages;
+    std::size_t nFormats = 0;
+    std::string_view format;
+    std::uint16_t formatId = 0;
+    LogFileEntry entry{};
+    std::size_t nBytes = 0;
+    while (readLogFileEntry(data, entry, nBytes) == LogFileReadStatus::OK) {
+        if (entry.type == LogFileEntryType::FORMAT && entry.format.starts_with("Binary message")) {
+            format = entry.format;
+            formatId = entry.formatId;
+            ++nFormats;
+        } else if (entry.type == LogFileEntryType::RECORD && !format.empty() && entry.record.header.formatId == formatId) {
+            std::string message;
+            formatLogMessage(entry.record, format, message);
+            messages.push_back(message);
+        }
+        data = data.subspan(nBytes);
+    }
+
+    EXPECT_EQ(logContent.substr(1, LOG_FILE_MAGIC.size()), std::string(LOG_FILE_MAGIC.data(), LOG_FILE_MAGIC.size()))
+        << "A binary log file should start with a header";
+    EXPECT_EQ(nFormats, 1u) << "Each format string should be written once per file";
+    EXPECT_EQ(messages, (std::vector<std::string>{"Binary message: 42 text", "Binary message: 43 text"}));
+}
+
+TEST_F(LoggerTest, ShutdownWritesTheWholeBacklog) {
+    // The logger is a singleton: destroy it at exit of a fresh process, so it starts draining with a backlog
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    const std::string backlogFileName = "test_log_shutdown_backlog.log";
+    std::remove(backlogFileName.c_str());
+
+    // Several full drain batches, all still in the ring when the logger stops
+    constexpr std::size_t N_MESSAGES = 3 * LOG_DRAIN_BATCH + 1;
+    static_assert(N_MESSAGES < LOG_RING_SIZE);
+    EXPECT_EXIT({
+        std::remove(logFileName.c_str());
+        Logger::setLogFile(backlogFileName);
+        auto& logger = Logger::getInstance(backlogFileName);
+        logger.pauseDraining();
+        for (std::size_t i = 0; i < N_MESSAGES; ++i) {
+            LOG_INFO("Shutdown backlog message {}", i);
+        }
+        std::exit(0);
+    }, ::testing::ExitedWithCode(0), "");
+
+    std::ifstream file(backlogFileName);
+    const std::string logContent{(std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()};
+    std::remove(backlogFileName.c_str());
+
+    EXPECT_EQ(static_cast<std::size_t>(std::count(logContent.begin(), logContent.end(), '\n')), N_MESSAGES)
+        << "Every record logged before stopping should be written";
+    EXPECT_NE(logContent.find(std::format("Shutdown backlog message {}\n", N_MESSAGES - 1)), std::string::npos);
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "core/gateway/fifo_Sequencer.h"
+#include "core/matching_engine/matching_engine.h"
+
+using namespace Exchange;
+
+class MatchingShardsTest : public ::testing::Test {
+  protected:
+    [[nodiscard]] static OMEClientRequest makeRequest(TickerID tickerId, OrderID orderId) {
+        return {OMEClientRequest::Type::NEW, 1, tickerId, orderId, Side::BUY, 100, 10};
+    }
+};
+
+TEST_F(MatchingShardsTest, SequencerRoutesRequestsByTicker) {
+    ClientRequestQueue shard0{64};
+    ClientRequestQueue shard1{64};
+    const std::array queues{&shard0, &shard1};
+    FIFOSequencer sequencer{queues};
+
+    // Requests read from one socket share their receive time and should keep their order
+    for (OrderID orderId = 1; orderId <= 8; ++orderId) {
+        sequencer.pushClientRequest(makeRequest(static_cast<TickerID>(orderId % 4), orderId), 1'000, 2'000);
+    }
+    sequencer.sequenceAndPublish();
+
+    for (const auto& [queue, expected] : {std::pair{&shard0, std::vector<OrderID>{2, 4, 6, 8}}, {&shard1, {1, 3, 5, 7}}}) {
+        for (const auto orderId : expected) {
+            const auto request = queue->pop();
+            ASSERT_TRUE(request.has_value()) << "Missing order " << orderId;
+            EXPECT_EQ(request->request.orderId, orderId) << "Requests should stay in sequence order within a shard";
+            EXPECT_EQ(getMatchingShard(request->request.tickerId, 2), queue == &shard0 ? 0u : 1u);
+        }
+        EXPECT_FALSE(queue->pop().has_value());
+    }
+}
+
+TEST_F(MatchingShardsTest, EngineOnlyMatchesItsTickers) {
+    ClientRequestQueue requests{64};
+    ClientResponseQueue responses{64};
+    MarketUpdateQueue updates{64};
+    MatchingEngine::MatchingEngine engine{requests, responses, updates, {1, 2, -1}};
+
+    engine.handleClientRequest(makeRequest(0, 1));
+    EXPECT_FALSE(responses.pop().has_value()) << "Ticker 0 belongs to shard 0";
+
+    engine.handleClientRequest(makeRequest(3, 2));
+    const auto response = responses.pop();
+    ASSERT_TRUE(response.has_value()) << "Ticker 3 belongs to shard 1";
+    EXPECT_EQ(response->response.type, OMEClientResponse::Type::ACCEPTED);
+    EXPECT_EQ(response->response.tickerId, 3u);
+}
+
+TEST_F(MatchingShardsTest, EngineMatchesQueuedRequestsInBatches) {
+    constexpr OrderID N_REQUESTS = 150;
+    ClientRequestQueue requests{256};
+    ClientResponseQueue responses{256};
+    MarketUpdateQueue updates{256};
+    MatchingEngine::MatchingEngine engine{requests, responses, updates};
+
+    // Queued before the engine starts, so they are drained in several full batches
+    for (OrderID orderId = 1; orderId <= N_REQUESTS; ++orderId) {
+        ASSERT_TRUE(requests.push({makeRequest(static_cast<TickerID>(orderId % 4), orderId), {}}));
+    }
+    engine.startMatchingEngine();
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    for (OrderID orderId = 1; orderId <= N_REQUESTS; ++orderId) {
+        auto response = responses.pop();
+        while (!response && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+            response = responses.pop();
+        }
+        ASSERT_TRUE(response.has_value()) << "Missing response to order " << orderId;
+        EXPECT_EQ(response->response.clientOrderId, orderId) << "Responses should keep the order of the requests";
+        EXPECT_NE(response->timing.tMatchEnd, 0u) << "Each published response should carry the end of its batch";
+    }
+    engine.stopMatchingEngine();
+}
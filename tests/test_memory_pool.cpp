@@ -121,3 +121,23 @@ TEST_F(MemoryPoolTest, OverAllocate) {
     EXPECT_EQ(pool.getFreeBlocksCount(), 0) << "Pool should have no free blocks";
 }
 
+
+TEST_F(MemoryPoolTest, ReusesFreedBlocksInFragmentedPool) {
+    std::vector<TestData*> allocated;
+    for (std::size_t i = 0; i < POOL_SIZE; ++i) {
+        allocated.push_back(pool.allocate(static_cast<int>(i)));
+    }
+
+    // Free every other block, leaving holes scattered across the pool
+    for (std::size_t i = 0; i < POOL_SIZE; i += 2) {
+        pool.deallocate(allocated[i]);
+    }
+    EXPECT_EQ(pool.getFreeBlocksCount(), POOL_SIZE / 2);
+
+    // Freed blocks are handed out again most recently freed first
+    for (std::size_t i = POOL_SIZE; i >= 2; i -= 2) {
+        EXPECT_EQ(pool.allocate(), allocated[i - 2]) << "Should reuse the block freed at slot " << i - 2;
+    }
+    EXPECT_EQ(pool.allocate(), nullptr) << "Pool should be full again once every hole is reused";
+    EXPECT_EQ(pool.getFreeBlocksCount(), 0);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <unordered_map>
+
+#include "lib/open_addressing_map.h"
+
+class OpenAddressingMapTest : public ::testing::Test {
+  protected:
+    static constexpr std::size_t MAX_ENTRIES = 100;
+    utils::OpenAddressingMap<std::int64_t, int> map{MAX_ENTRIES};
+};
+
+TEST_F(OpenAddressingMapTest, InitialStateIsEmpty) {
+    EXPECT_TRUE(map.empty()) << "Map should be empty upon initialization";
+    EXPECT_EQ(map.find(42), nullptr);
+    EXPECT_GE(map.capacity(), 2 * MAX_ENTRIES) << "Map should keep its load factor at or below one half";
+}
+
+TEST_F(OpenAddressingMapTest, InsertFindErase) {
+    EXPECT_TRUE(map.insert(-7, 1));
+    EXPECT_TRUE(map.insert(7, 2));
+    ASSERT_NE(map.find(-7), nullptr);
+    EXPECT_EQ(*map.find(-7), 1);
+    EXPECT_EQ(*map.find(7), 2);
+    EXPECT_EQ(map.size(), 2u);
+
+    EXPECT_TRUE(map.insert(7, 3)) << "Inserting an existing key should overwrite its value";
+    EXPECT_EQ(*map.find(7), 3);
+    EXPECT_EQ(map.size(), 2u);
+
+    EXPECT_TRUE(map.erase(-7));
+    EXPECT_FALSE(map.erase(-7)) << "Erasing a missing key should fail";
+    EXPECT_EQ(map.find(-7), nullptr);
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST_F(OpenAddressingMapTest, InsertUntilFull) {
+    for (std::size_t i = 0; i < MAX_ENTRIES; ++i) {
+        EXPECT_TRUE(map.insert(static_cast<std::int64_t>(i), static_cast<int>(i))) << "Should be able to insert key " << i;
+    }
+    EXPECT_FALSE(map.insert(static_cast<std::int64_t>(MAX_ENTRIES), 0)) << "Should fail to insert a new key when full";
+    EXPECT_TRUE(map.insert(0, 5)) << "Overwriting an existing key should still succeed when full";
+}
+
+TEST_F(OpenAddressingMapTest, MatchesReferenceMapUnderChurn) {
+    std::mt19937_64 rng(7);
+    std::unordered_map<std::int64_t, int> reference;
+
+    for (int i = 0; i < 50000; ++i) {
+        const auto key = static_cast<std::int64_t>(rng() % 300) - 150;
+        if (rng() % 2 && reference.size() < MAX_ENTRIES) {
+            EXPECT_TRUE(map.insert(key, i));
+            reference[key] = i;
+        } else {
+            EXPECT_EQ(map.erase(key), reference.erase(key) == 1) << "Erase mismatch for key " << key;
+        }
+    }
+
+    EXPECT_EQ(map.size(), reference.size());
+    for (std::int64_t key = -150; key < 150; ++key) {
+        const auto found = map.find(key);
+        const auto expected = reference.find(key);
+        ASSERT_EQ(found != nullptr, expected != reference.end()) << "Presence mismatch for key " << key;
+        if (found) {
+            EXPECT_EQ(*found, expected->second);
+        }
+    }
+
+    std::size_t visited = 0;
+    map.forEach([&](std::int64_t key, int value) {
+        ++visited;
+        EXPECT_EQ(reference.at(key), value);
+    });
+    EXPECT_EQ(visited, reference.size());
+}
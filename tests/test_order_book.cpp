@@ -0,0 +1,442 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/matching_engine/order_book.h"
+#include "core/matching_engine/order_book_sink.h"
+
+using namespace Exchange;
+
+class OrderBookTest : public ::testing::Test {
+  protected:
+    static constexpr TickerID TICKER = 0;
+
+    /**
+     * @brief Returns the prices of the fills reported to a client so far, in execution order.
+     */
+    [[nodiscard]] std::vector<Price> fillPrices(ClientID clientId) const {
+        std::vector<Price> prices;
+        for (const auto& response : sink_.responses) {
+            if (response.type == OMEClientResponse::Type::FILLED && response.clientId == clientId) {
+                prices.push_back(response.price);
+            }
+        }
+        return prices;
+    }
+
+    /**
+     * @brief Checks that the bid and ask levels are linked from the best price outwards.
+     */
+    void expectLevelsSorted() const {
+        EXPECT_NO_THROW(static_cast<void>(book_->toString(false, true)));
+    }
+
+    MatchingEngine::VectorSink sink_;
+    std::unique_ptr<MatchingEngine::BasicOrderBook<MatchingEngine::VectorSink>> book_ =
+        std::make_unique<MatchingEngine::BasicOrderBook<MatchingEngine::VectorSink>>(TICKER, sink_);
+};
+
+TEST_F(OrderBookTest, PassiveOrderIsAcceptedAndAdded) {
+    book_->addOrder(1, 10, TICKER, Side::BUY, 100, 5);
+
+    ASSERT_EQ(sink_.responses.size(), 1u);
+    EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::ACCEPTED);
+    EXPECT_EQ(sink_.responses[0].clientOrderId, 10u);
+    ASSERT_EQ(sink_.marketUpdates.size(), 1u);
+    EXPECT_EQ(sink_.marketUpdates[0].type, OMEMarketUpdate::Type::ADD);
+    EXPECT_EQ(sink_.marketUpdates[0].price, 100);
+    EXPECT_EQ(sink_.marketUpdates[0].qty, 5u);
+}
+
+TEST_F(OrderBookTest, AggressiveOrderFillsBothSides) {
+    book_->addOrder(1, 10, TICKER, Side::SELL, 100, 5);
+    sink_.clear();
+
+    book_->addOrder(2, 20, TICKER, Side::BUY, 101, 3);
+
+    ASSERT_EQ(sink_.responses.size(), 3u);
+    EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::ACCEPTED);
+    EXPECT_EQ(sink_.responses[1].type, OMEClientResponse::Type::FILLED);
+    EXPECT_EQ(sink_.responses[1].clientId, 2u);
+    EXPECT_EQ(sink_.responses[1].price, 100) << "Fills happen at the resting price";
+    EXPECT_EQ(sink_.responses[1].qtyExec, 3u);
+    EXPECT_EQ(sink_.responses[2].type, OMEClientResponse::Type::FILLED);
+    EXPECT_EQ(sink_.responses[2].clientId, 1u);
+    EXPECT_EQ(sink_.responses[2].qtyRemain, 2u);
+
+    ASSERT_EQ(sink_.marketUpdates.size(), 2u) << "Fully filled aggressor, nothing added";
+    EXPECT_EQ(sink_.marketUpdates[0].type, OMEMarketUpdate::Type::TRADE);
+    EXPECT_EQ(sink_.marketUpdates[1].type, OMEMarketUpdate::Type::MODIFY);
+    EXPECT_EQ(sink_.marketUpdates[1].qty, 2u);
+}
+
+TEST_F(OrderBookTest, CancelRemovesOrderOrIsRejected) {
+    book_->addOrder(1, 10, TICKER, Side::BUY, 100, 5);
+    sink_.clear();
+
+    book_->cancelOrder(1, 10, TICKER);
+    ASSERT_EQ(sink_.responses.size(), 1u);
+    EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::CANCELLED);
+    ASSERT_EQ(sink_.marketUpdates.size(), 1u);
+    EXPECT_EQ(sink_.marketUpdates[0].type, OMEMarketUpdate::Type::CANCEL);
+    sink_.clear();
+
+    book_->cancelOrder(1, 10, TICKER);
+    ASSERT_EQ(sink_.responses.size(), 1u);
+    EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::CANCEL_REJECTED);
+    EXPECT_TRUE(sink_.marketUpdates.empty());
+}
+
+TEST_F(OrderBookTest, ImmediateOrCancelRemainderNeverRests) {
+    book_->addOrder(1, 10, TICKER, Side::SELL, 100, 5);
+    sink_.clear();
+
+    book_->addImmediateOrder(2, 20, TICKER, Side::BUY, 100, 8, false);
+
+    ASSERT_EQ(sink_.responses.size(), 4u);
+    EXPECT_EQ(sink_.responses[1].qtyExec, 5u);
+    EXPECT_EQ(sink_.responses[3].type, OMEClientResponse::Type::CANCELLED);
+    EXPECT_EQ(sink_.responses[3].clientOrderId, 20u);
+    EXPECT_EQ(sink_.responses[3].qtyRemain, 3u);
+    for (const auto& update : sink_.marketUpdates) {
+        EXPECT_NE(update.type, OMEMarketUpdate::Type::ADD) << "The remainder should not be added to the book";
+    }
+    sink_.clear();
+
+    book_->cancelOrder(2, 20, TICKER);
+    ASSERT_EQ(sink_.responses.size(), 1u);
+    EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::CANCEL_REJECTED);
+}
+
+TEST_F(OrderBookTest, FillOrKillWithoutEnoughLiquidityLeavesBookUntouched) {
+    book_->addOrder(1, 10, TICKER, Side::SELL, 100, 5);
+    book_->addOrder(1, 11, TICKER, Side::SELL, 102, 5);
+    sink_.clear();
+
+    book_->addImmediateOrder(2, 20, TICKER, Side::BUY, 101, 6, true);
+    ASSERT_EQ(sink_.responses.size(), 2u);
+    EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::ACCEPTED);
+    EXPECT_EQ(sink_.responses[1].type, OMEClientResponse::Type::CANCELLED);
+    EXPECT_EQ(sink_.responses[1].qtyRemain, 6u);
+    EXPECT_TRUE(sink_.marketUpdates.empty());
+    sink_.clear();
+
+    book_->addImmediateOrder(2, 21, TICKER, Side::BUY, 102, 6, true);
+    ASSERT_EQ(sink_.responses.size(), 5u) << "Filled in full across two levels";
+    EXPECT_EQ(sink_.responses[1].qtyExec, 5u);
+    EXPECT_EQ(sink_.responses[3].qtyExec, 1u);
+    EXPECT_EQ(sink_.responses[3].qtyRemain, 0u);
+}
+
+TEST_F(OrderBookTest, MarketOrderIsProtectedAroundBestPrice) {
+    constexpr auto PROTECTION = static_cast<Price>(Types::MARKET_PROTECTION_TICKS);
+    book_->addOrder(1, 10, TICKER, Side::BUY, 100, 5);
+    book_->addOrder(1, 11, TICKER, Side::BUY, 100 - PROTECTION - 1, 5);
+    sink_.clear();
+
+    book_->addMarketOrder(2, 20, TICKER, Side::SELL, 10);
+    ASSERT_EQ(sink_.responses.size(), 4u);
+    EXPECT_EQ(sink_.responses[1].price, 100);
+    EXPECT_EQ(sink_.responses[3].type, OMEClientResponse::Type::CANCELLED) << "The bid past the protection should not trade";
+    EXPECT_EQ(sink_.responses[3].qtyRemain, 5u);
+    sink_.clear();
+
+    book_->addMarketOrder(2, 21, TICKER, Side::BUY, 10);
+    ASSERT_EQ(sink_.responses.size(), 2u) << "No ask to trade against";
+    EXPECT_EQ(sink_.responses[1].type, OMEClientResponse::Type::CANCELLED);
+}
+
+TEST_F(OrderBookTest, LevelsInsertedMidBookKeepPriceOrder) {
+    // New best levels, levels between existing ones and levels behind the worst one
+    OrderID orderId = 1;
+    for (const Price offset : {20, 40, 0, 10, 30, 5, 35, 50, 1}) {
+        book_->addOrder(1, orderId++, TICKER, Side::SELL, 1000 + offset, 5);
+        book_->addOrder(1, orderId++, TICKER, Side::BUY, 999 - offset, 5);
+        expectLevelsSorted();
+    }
+    sink_.clear();
+
+    // Each sweep takes every level of a side, from the best price outwards
+    book_->addOrder(2, 1, TICKER, Side::BUY, 1050, 45);
+    EXPECT_EQ(fillPrices(2), (std::vector<Price>{1000, 1001, 1005, 1010, 1020, 1030, 1035, 1040, 1050}));
+    sink_.clear();
+
+    book_->addOrder(3, 1, TICKER, Side::SELL, 949, 45);
+    EXPECT_EQ(fillPrices(3), (std::vector<Price>{999, 998, 994, 989, 979, 969, 964, 959, 949}));
+    EXPECT_TRUE(std::ranges::none_of(sink_.marketUpdates, [](const auto& update) { return update.type == OMEMarketUpdate::Type::ADD; }))
+        << "Both sweeps are filled in full";
+}
+
+TEST_F(OrderBookTest, PartialSweepStopsAtLimitPrice) {
+    for (OrderID orderId = 1; orderId <= 4; ++orderId) {
+        book_->addOrder(1, orderId, TICKER, Side::SELL, 100 + static_cast<Price>(5 - orderId), 5);
+    }
+    sink_.clear();
+
+    book_->addOrder(2, 1, TICKER, Side::BUY, 102, 20);
+    EXPECT_EQ(fillPrices(2), (std::vector<Price>{101, 102}));
+    ASSERT_FALSE(sink_.marketUpdates.empty());
+    EXPECT_EQ(sink_.marketUpdates.back().type, OMEMarketUpdate::Type::ADD) << "The remainder rests as the new best bid";
+    EXPECT_EQ(sink_.marketUpdates.back().qty, 10u);
+    sink_.clear();
+
+    // The asks left are still matched from the best one
+    book_->addOrder(3, 1, TICKER, Side::BUY, 104, 10);
+    EXPECT_EQ(fillPrices(3), (std::vector<Price>{103, 104}));
+    expectLevelsSorted();
+}
+
+TEST_F(OrderBookTest, PricesSharingASlotStaySeparateLevels) {
+    // 256 ticks apart aliased under the former modulo mapping, PRICE_WINDOW_TICKS apart share a ring slot
+    constexpr Price BASE_PRICE = 10'000;
+    constexpr auto WINDOW = static_cast<Price>(Types::PRICE_WINDOW_TICKS);
+    for (const auto side : {Side::SELL, Side::BUY}) {
+        book_.reset();
+        book_ = std::make_unique<MatchingEngine::BasicOrderBook<MatchingEngine::VectorSink>>(TICKER, sink_);
+        const Price away = side == Side::SELL ? 1 : -1;
+        const std::vector<Price> prices{BASE_PRICE, BASE_PRICE + away * 256, BASE_PRICE + away * WINDOW};
+        const auto aggressorSide = side == Side::SELL ? Side::BUY : Side::SELL;
+
+        // Order i is filled and order 10 + i cancelled, from the best level outwards
+        for (OrderID i = 0; i < prices.size(); ++i) {
+            book_->addOrder(1, i, TICKER, side, prices[i], 5);
+            book_->addOrder(1, 10 + i, TICKER, side, prices[i], 5);
+        }
+        expectLevelsSorted();
+
+        for (OrderID i = 0; i < prices.size(); ++i) {
+            sink_.clear();
+            book_->cancelOrder(1, 10 + i, TICKER);
+            ASSERT_EQ(sink_.responses.size(), 1u);
+            EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::CANCELLED);
+            EXPECT_EQ(sink_.responses[0].price, prices[i]);
+            ASSERT_EQ(sink_.marketUpdates.size(), 1u);
+            EXPECT_EQ(sink_.marketUpdates[0].price, prices[i]);
+
+            sink_.clear();
+            book_->addImmediateOrder(2, i, TICKER, aggressorSide, prices[i], 10, false);
+            EXPECT_EQ(fillPrices(2), std::vector<Price>{prices[i]}) << "Only order " << i << " should be left to fill";
+            EXPECT_EQ(fillPrices(1), std::vector<Price>{prices[i]});
+            EXPECT_EQ(sink_.responses.back().type, OMEClientResponse::Type::CANCELLED);
+            EXPECT_EQ(sink_.responses.back().qtyRemain, 5u);
+            expectLevelsSorted();
+        }
+
+        for (OrderID i = 0; i < prices.size(); ++i) {
+            sink_.clear();
+            book_->cancelOrder(1, i, TICKER);
+            book_->cancelOrder(1, 10 + i, TICKER);
+            ASSERT_EQ(sink_.responses.size(), 2u);
+            EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::CANCEL_REJECTED);
+            EXPECT_EQ(sink_.responses[1].type, OMEClientResponse::Type::CANCEL_REJECTED);
+        }
+    }
+}
+
+TEST_F(OrderBookTest, OutliersOutsideWindowAreOrderedAndMatched) {
+    constexpr Price BASE_PRICE = 10'000;
+    constexpr auto WINDOW = static_cast<Price>(Types::PRICE_WINDOW_TICKS);
+    // The window is centered on the first level, the outliers land on both sides of it in any order
+    OrderID orderId = 1;
+    for (const Price bid : {BASE_PRICE, BASE_PRICE - 2 * WINDOW, BASE_PRICE - WINDOW, BASE_PRICE - 3 * WINDOW, BASE_PRICE - 10}) {
+        book_->addOrder(1, orderId++, TICKER, Side::BUY, bid, 5);
+    }
+    for (const Price ask : {BASE_PRICE + 10, BASE_PRICE + 2 * WINDOW, BASE_PRICE + WINDOW, BASE_PRICE + 3 * WINDOW}) {
+        book_->addOrder(1, orderId++, TICKER, Side::SELL, ask, 5);
+    }
+    expectLevelsSorted();
+    sink_.clear();
+
+    // An aggressive outlier sweeps into the passive outliers, its remainder rests as an outlier ask
+    book_->addOrder(2, 1, TICKER, Side::SELL, BASE_PRICE - 2 * WINDOW, 25);
+    EXPECT_EQ(fillPrices(2), (std::vector<Price>{BASE_PRICE, BASE_PRICE - 10, BASE_PRICE - WINDOW, BASE_PRICE - 2 * WINDOW}));
+    ASSERT_FALSE(sink_.marketUpdates.empty());
+    EXPECT_EQ(sink_.marketUpdates.back().type, OMEMarketUpdate::Type::ADD);
+    EXPECT_EQ(sink_.marketUpdates.back().price, BASE_PRICE - 2 * WINDOW);
+    expectLevelsSorted();
+    sink_.clear();
+
+    book_->addOrder(3, 1, TICKER, Side::BUY, BASE_PRICE + 3 * WINDOW, 25);
+    EXPECT_EQ(fillPrices(3), (std::vector<Price>{BASE_PRICE - 2 * WINDOW, BASE_PRICE + 10, BASE_PRICE + WINDOW,
+                                                 BASE_PRICE + 2 * WINDOW, BASE_PRICE + 3 * WINDOW}));
+    sink_.clear();
+
+    // Only the deepest bid is left
+    book_->addOrder(4, 1, TICKER, Side::SELL, BASE_PRICE - 3 * WINDOW, 10);
+    EXPECT_EQ(fillPrices(4), std::vector<Price>{BASE_PRICE - 3 * WINDOW});
+    EXPECT_EQ(sink_.marketUpdates.back().type, OMEMarketUpdate::Type::ADD);
+    EXPECT_EQ(sink_.marketUpdates.back().qty, 5u);
+}
+
+TEST_F(OrderBookTest, MatchingStaysCorrectAfterWindowRecenters) {
+    constexpr Price BASE_PRICE = 10'000;
+    constexpr auto WINDOW = static_cast<Price>(Types::PRICE_WINDOW_TICKS);
+    // The window is first centered on a far ask, then the climbing bids drag the mid across several windows
+    book_->addOrder(1, 1, TICKER, Side::SELL, BASE_PRICE + 4 * WINDOW, 5);
+    OrderID orderId = 2;
+    std::vector<Price> bids;
+    for (Price bid = BASE_PRICE; bid <= BASE_PRICE + 3 * WINDOW; bid += WINDOW / 8) {
+        book_->addOrder(1, orderId++, TICKER, Side::BUY, bid, 5);
+        bids.push_back(bid);
+        expectLevelsSorted();
+    }
+
+    // A level between two recentered ones and another order at the best bid, behind the first one
+    book_->addOrder(1, orderId++, TICKER, Side::BUY, BASE_PRICE + 2 * WINDOW + 1, 5);
+    bids.push_back(BASE_PRICE + 2 * WINDOW + 1);
+    book_->addOrder(1, orderId++, TICKER, Side::BUY, BASE_PRICE + 3 * WINDOW, 5);
+    bids.push_back(BASE_PRICE + 3 * WINDOW);
+    expectLevelsSorted();
+    sink_.clear();
+
+    book_->addOrder(2, 1, TICKER, Side::SELL, BASE_PRICE + 3 * WINDOW, 7);
+    EXPECT_EQ(fillPrices(2), (std::vector<Price>{BASE_PRICE + 3 * WINDOW, BASE_PRICE + 3 * WINDOW}));
+    sink_.clear();
+
+    // Sweep every bid left, from the best outwards
+    std::ranges::sort(bids, std::greater{});
+    book_->addOrder(3, 1, TICKER, Side::SELL, BASE_PRICE, static_cast<Qty>(5 * bids.size() - 7));
+    EXPECT_EQ(fillPrices(3), std::vector<Price>(bids.begin() + 1, bids.end()));
+    EXPECT_TRUE(std::ranges::none_of(sink_.marketUpdates, [](const auto& update) { return update.type == OMEMarketUpdate::Type::ADD; }));
+    sink_.clear();
+
+    book_->addOrder(4, 1, TICKER, Side::BUY, BASE_PRICE + 4 * WINDOW, 5);
+    EXPECT_EQ(fillPrices(4), std::vector<Price>{BASE_PRICE + 4 * WINDOW});
+    expectLevelsSorted();
+}
+
+TEST_F(OrderBookTest, ClientOrderIdsBeyondOrderCapacityAreIndexed) {
+    constexpr OrderID LARGE_ID = Types::MAX_ORDER_IDS + 7;
+    constexpr OrderID LARGEST_ID = OrderID_INVALID - 1;
+    book_->addOrder(1, LARGE_ID, TICKER, Side::BUY, 100, 5);
+    book_->addOrder(1, LARGEST_ID, TICKER, Side::BUY, 99, 6);
+    sink_.clear();
+
+    book_->cancelOrder(1, LARGE_ID, TICKER);
+    book_->cancelOrder(1, LARGEST_ID, TICKER);
+    ASSERT_EQ(sink_.responses.size(), 2u);
+    EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::CANCELLED);
+    EXPECT_EQ(sink_.responses[0].clientOrderId, LARGE_ID);
+    EXPECT_EQ(sink_.responses[0].qtyRemain, 5u);
+    EXPECT_EQ(sink_.responses[1].type, OMEClientResponse::Type::CANCELLED);
+    EXPECT_EQ(sink_.responses[1].clientOrderId, LARGEST_ID);
+    EXPECT_EQ(sink_.responses[1].qtyRemain, 6u);
+    EXPECT_EQ(sink_.marketUpdates.size(), 2u);
+}
+
+TEST_F(OrderBookTest, SameClientOrderIdOfTwoClientsAreDistinct) {
+    book_->addOrder(1, 5, TICKER, Side::BUY, 100, 5);
+    book_->addOrder(2, 5, TICKER, Side::BUY, 101, 6);
+    sink_.clear();
+
+    book_->cancelOrder(2, 5, TICKER);
+    ASSERT_EQ(sink_.responses.size(), 1u);
+    EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::CANCELLED);
+    EXPECT_EQ(sink_.responses[0].clientId, 2u);
+    EXPECT_EQ(sink_.responses[0].price, 101);
+    sink_.clear();
+
+    // The order of client 1 is still live and matchable
+    book_->addOrder(3, 1, TICKER, Side::SELL, 100, 5);
+    EXPECT_EQ(fillPrices(1), std::vector<Price>{100});
+    sink_.clear();
+
+    book_->cancelOrder(1, 5, TICKER);
+    book_->cancelOrder(2, 5, TICKER);
+    ASSERT_EQ(sink_.responses.size(), 2u);
+    EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::CANCEL_REJECTED);
+    EXPECT_EQ(sink_.responses[1].type, OMEClientResponse::Type::CANCEL_REJECTED);
+}
+
+TEST_F(OrderBookTest, CancelAfterFullFillIsRejected) {
+    book_->addOrder(1, 10, TICKER, Side::SELL, 100, 5);
+    book_->addOrder(2, 20, TICKER, Side::BUY, 100, 5);
+    sink_.clear();
+
+    book_->cancelOrder(1, 10, TICKER);
+    book_->cancelOrder(2, 20, TICKER);
+    ASSERT_EQ(sink_.responses.size(), 2u);
+    EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::CANCEL_REJECTED) << "The passive order was filled in full";
+    EXPECT_EQ(sink_.responses[1].type, OMEClientResponse::Type::CANCEL_REJECTED) << "The aggressive order never rested";
+    EXPECT_TRUE(sink_.marketUpdates.empty());
+
+    // The client order ID can be reused once the order is gone
+    book_->addOrder(1, 10, TICKER, Side::SELL, 100, 5);
+    sink_.clear();
+    book_->cancelOrder(1, 10, TICKER);
+    ASSERT_EQ(sink_.responses.size(), 1u);
+    EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::CANCELLED);
+}
+
+TEST_F(OrderBookTest, PriceLevelIsWalkedInTimePriority) {
+    for (OrderID orderId = 1; orderId <= 5; ++orderId) {
+        book_->addOrder(static_cast<ClientID>(orderId), orderId, TICKER, Side::SELL, 100, 5);
+        ASSERT_EQ(sink_.marketUpdates.back().type, OMEMarketUpdate::Type::ADD);
+        EXPECT_EQ(sink_.marketUpdates.back().priority, orderId);
+    }
+
+    // Unlink the head and a middle order, then append behind the tail
+    book_->cancelOrder(1, 1, TICKER);
+    book_->cancelOrder(3, 3, TICKER);
+    book_->addOrder(9, 9, TICKER, Side::SELL, 100, 5);
+    EXPECT_EQ(sink_.marketUpdates.back().priority, 6u) << "Priorities follow the tail of the level";
+    sink_.clear();
+
+    book_->addOrder(10, 10, TICKER, Side::BUY, 100, 17);
+    std::vector<ClientID> filledClients;
+    for (const auto& response : sink_.responses) {
+        if (response.type == OMEClientResponse::Type::FILLED && response.clientId != 10) {
+            filledClients.push_back(response.clientId);
+        }
+    }
+    EXPECT_EQ(filledClients, (std::vector<ClientID>{2, 4, 5, 9}));
+    EXPECT_EQ(sink_.responses.back().qtyExec, 2u);
+    EXPECT_EQ(sink_.responses.back().qtyRemain, 3u);
+    EXPECT_EQ(sink_.marketUpdates.back().type, OMEMarketUpdate::Type::MODIFY);
+    EXPECT_EQ(sink_.marketUpdates.back().qty, 3u);
+    sink_.clear();
+
+    // The partially filled tail is now the only order of the level
+    book_->cancelOrder(9, 9, TICKER);
+    book_->cancelOrder(2, 2, TICKER);
+    ASSERT_EQ(sink_.responses.size(), 2u);
+    EXPECT_EQ(sink_.responses[0].type, OMEClientResponse::Type::CANCELLED);
+    EXPECT_EQ(sink_.responses[0].qtyRemain, 3u);
+    EXPECT_EQ(sink_.responses[1].type, OMEClientResponse::Type::CANCEL_REJECTED);
+    expectLevelsSorted();
+}
+
+TEST_F(OrderBookTest, FinalDumpIsLoggedInFull) {
+    const auto logFileName = std::format("test_order_book_{}.log", std::chrono::system_clock::now().time_since_epoch().count());
+    utils::Logger::setLogFile(logFileName);
+
+    // Far more levels than a single log record can hold
+    constexpr OrderID N_LEVELS = 20;
+    for (OrderID orderId = 1; orderId <= N_LEVELS; ++orderId) {
+        book_->addOrder(1, orderId, TICKER, Side::SELL, 1000 + static_cast<Price>(orderId), 5);
+        book_->addOrder(1, N_LEVELS + orderId, TICKER, Side::BUY, 1000 - static_cast<Price>(orderId), 5);
+    }
+    book_.reset();
+
+    // The bids are dumped last, wait for the logger thread to write the deepest one
+    const auto lastLine = std::format("BIDS[{}] =>", N_LEVELS - 1);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    std::string logContent;
+    while (logContent.find(lastLine) == std::string::npos && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::ifstream file(logFileName);
+        logContent.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    for (OrderID level = 0; level < N_LEVELS; ++level) {
+        EXPECT_NE(logContent.find(std::format("ASKS[{}] =>", level)), std::string::npos) << "Missing ask level " << level;
+        EXPECT_NE(logContent.find(std::format("BIDS[{}] =>", level)), std::string::npos) << "Missing bid level " << level;
+    }
+    std::remove(logFileName.c_str());
+}
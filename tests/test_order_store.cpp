@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "core/exchange/matching_engine_order.h"
+
+using namespace Exchange;
+
+class OrderStoreTest : public ::testing::Test {
+  protected:
+    static constexpr std::size_t CAPACITY = 8;
+
+    /**
+     * @brief Stores an order whose fields are all derived from its client order ID.
+     */
+    OrderIndex allocate(OrderID clientOrderId) {
+        return store_.allocate(static_cast<TickerID>(clientOrderId % 4), static_cast<ClientID>(clientOrderId + 1), clientOrderId,
+                               clientOrderId + 1000, clientOrderId % 2 ? Side::BUY : Side::SELL,
+                               static_cast<Price>(100 + clientOrderId), static_cast<Qty>(10 * clientOrderId), clientOrderId + 2);
+    }
+
+    /**
+     * @brief Checks that the hot and cold fields of an index belong to the order allocated with that ID.
+     */
+    void expectOrder(OrderIndex index, OrderID clientOrderId) const {
+        const auto& hot = store_.hot(index);
+        const auto& cold = store_.cold(index);
+        EXPECT_EQ(cold.clientOrderId_, clientOrderId);
+        EXPECT_EQ(cold.marketOrderId_, clientOrderId + 1000);
+        EXPECT_EQ(cold.clientId_, clientOrderId + 1);
+        EXPECT_EQ(cold.tickerId_, clientOrderId % 4);
+        EXPECT_EQ(hot.side_, clientOrderId % 2 ? Side::BUY : Side::SELL);
+        EXPECT_EQ(hot.price_, static_cast<Price>(100 + clientOrderId));
+        EXPECT_EQ(hot.qty_, 10 * clientOrderId);
+        EXPECT_EQ(hot.priority_, clientOrderId + 2);
+        EXPECT_EQ(hot.prev_, OrderIndex_INVALID) << "A new order is not linked to a price level yet";
+        EXPECT_EQ(hot.next_, OrderIndex_INVALID) << "A new order is not linked to a price level yet";
+    }
+
+    OrderStore store_{CAPACITY};
+};
+
+TEST_F(OrderStoreTest, AllocatesEverySlotThenReportsFull) {
+    EXPECT_EQ(store_.capacity(), CAPACITY);
+    EXPECT_EQ(store_.size(), 0u);
+    for (OrderID id = 0; id < CAPACITY; ++id) {
+        EXPECT_EQ(allocate(id), id) << "Fresh slots are handed out in index order";
+    }
+    EXPECT_EQ(store_.size(), CAPACITY);
+    EXPECT_EQ(allocate(CAPACITY), OrderIndex_INVALID) << "The store should be full";
+    EXPECT_EQ(store_.size(), CAPACITY);
+}
+
+TEST_F(OrderStoreTest, ReleasedSlotsAreReusedLastInFirstOut) {
+    for (OrderID id = 0; id < 4; ++id) {
+        ASSERT_EQ(allocate(id), id);
+    }
+    store_.deallocate(1);
+    store_.deallocate(3);
+    EXPECT_EQ(store_.size(), 2u);
+    EXPECT_EQ(store_.hot(1).side_, Side::INVALID) << "A released slot is marked free";
+
+    EXPECT_EQ(allocate(10), 3u);
+    EXPECT_EQ(allocate(11), 1u);
+    EXPECT_EQ(allocate(12), 4u) << "Once the released slots are reused, the untouched ones follow";
+    EXPECT_EQ(store_.size(), 5u);
+}
+
+TEST_F(OrderStoreTest, HotAndColdFieldsStayPaired) {
+    std::vector<OrderID> idAt(CAPACITY);
+    for (OrderID id = 0; id < CAPACITY; ++id) {
+        idAt[allocate(id)] = id;
+    }
+    // Churn half of the slots so that reused slots sit between live ones
+    for (OrderIndex index = 0; index < CAPACITY; index += 2) {
+        store_.deallocate(index);
+    }
+    for (OrderID id = 100; id < 100 + CAPACITY / 2; ++id) {
+        const auto index = allocate(id);
+        ASSERT_NE(index, OrderIndex_INVALID);
+        idAt[index] = id;
+    }
+
+    for (OrderIndex index = 0; index < CAPACITY; ++index) {
+        SCOPED_TRACE(index);
+        expectOrder(index, idAt[index]);
+    }
+}
+
+TEST_F(OrderStoreTest, ReleasingAFreeSlotAsserts) {
+    const auto index = allocate(1);
+    store_.deallocate(index);
+    EXPECT_DEATH(store_.deallocate(index), "Expected in-use order");
+}
+
+TEST_F(OrderStoreTest, CapacityBeyondOrderIndexRangeAsserts) {
+    EXPECT_DEATH(OrderStore{OrderIndex_INVALID}, "exceeds the OrderIndex range");
+}
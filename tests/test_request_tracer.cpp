@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+
+#include "core/gateway/request_tracer.h"
+
+using namespace Exchange;
+
+class RequestTracerTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() /
+               std::format("request_tracer_{}.json", std::chrono::system_clock::now().time_since_epoch().count());
+        ASSERT_TRUE(tracer.open(path.string())) << "Failed to open " << path;
+    }
+
+    void TearDown() override {
+        tracer.setSampleInterval(0);
+        std::filesystem::remove(path);
+    }
+
+    [[nodiscard]] std::string readFile() const {
+        std::ifstream stream(path);
+        return std::string{(std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>()};
+    }
+
+    [[nodiscard]] static std::size_t countOf(const std::string& text, std::string_view pattern) {
+        std::size_t count = 0;
+        for (auto i = text.find(pattern); i != std::string::npos; i = text.find(pattern, i + 1)) {
+            ++count;
+        }
+        return count;
+    }
+
+    RequestTracer& tracer = RequestTracer::getInstance();
+    std::filesystem::path path;
+};
+
+TEST_F(RequestTracerTest, SamplesOneRequestInN) {
+    EXPECT_EQ(tracer.sample(), 0u) << "Tracing should be disabled by default";
+
+    tracer.setSampleInterval(4);
+    std::uint32_t nSampled = 0;
+    std::uint32_t lastTraceId = 0;
+    for (int i = 0; i < 400; ++i) {
+        if (const auto traceId = tracer.sample()) {
+            EXPECT_GT(traceId, lastTraceId) << "Trace IDs should be unique and increasing";
+            lastTraceId = traceId;
+            ++nSampled;
+        }
+    }
+    EXPECT_EQ(nSampled, 100u);
+}
+
+TEST_F(RequestTracerTest, ExportsTimelinesInTraceEventFormat) {
+    RequestTiming timing{1'000'000, 1'002'000, 1'003'500, 1'004'000, 1'010'250, 7, true};
+    OMEClientResponse response;
+    response.type = OMEClientResponse::Type::ACCEPTED;
+    response.clientId = 3;
+    tracer.complete({response, timing}, 1'012'000);
+    timing.isFirstResponse = false;
+    response.type = OMEClientResponse::Type::FILLED;
+    tracer.complete({response, timing}, 1'013'000);
+    tracer.complete({response, {}}, 1'014'000);
+
+    EXPECT_EQ(tracer.exportTraces(), 2u) << "Responses of untraced requests should be ignored";
+    ASSERT_TRUE(tracer.open(path.string() + ".next"));
+    std::filesystem::remove(path.string() + ".next");
+
+    const auto trace = readFile();
+    EXPECT_EQ(trace.front(), '[');
+    EXPECT_EQ(trace.substr(trace.size() - 3), "\n]\n") << "The trace should be completed when the next one is opened";
+    EXPECT_EQ(countOf(trace, "\"ph\":\"X\""), 6u) << "4 request hops written once plus 2 responses:\n" << trace;
+    EXPECT_EQ(countOf(trace, "},\n{"), 5u) << "Events should be comma separated:\n" << trace;
+    EXPECT_NE(trace.find("\"name\":\"KERNEL_TO_GATEWAY\",\"cat\":\"request\",\"ph\":\"X\",\"ts\":1000.000,\"dur\":2.000,\"pid\":1,\"tid\":7"),
+              std::string::npos) << trace;
+    EXPECT_NE(trace.find("\"name\":\"MATCHING\",\"cat\":\"request\",\"ph\":\"X\",\"ts\":1004.000,\"dur\":6.250"), std::string::npos) << trace;
+    EXPECT_NE(trace.find("\"name\":\"FILLED\",\"cat\":\"request\",\"ph\":\"X\",\"ts\":1010.250,\"dur\":2.750,\"pid\":1,\"tid\":7,"
+                         "\"args\":{\"traceId\":7,\"clientId\":3"), std::string::npos) << trace;
+}
+
+TEST_F(RequestTracerTest, RequestHopsAreWrittenOnceWhenResponsesInterleave) {
+    // The responses of request 1 are split by a response of request 2, published by another shard
+    RequestTiming first{0, 1'000'000, 1'001'000, 1'002'000, 1'003'000, 1, true};
+    RequestTiming second{0, 1'000'500, 1'001'500, 1'002'500, 1'003'500, 2, true};
+    OMEClientResponse response;
+    response.type = OMEClientResponse::Type::ACCEPTED;
+    tracer.complete({response, first}, 1'004'000);
+    tracer.complete({response, second}, 1'004'500);
+    first.isFirstResponse = false;
+    response.type = OMEClientResponse::Type::FILLED;
+    tracer.complete({response, first}, 1'005'000);
+
+    EXPECT_EQ(tracer.exportTraces(), 3u);
+    ASSERT_TRUE(tracer.open(path.string() + ".next"));
+    std::filesystem::remove(path.string() + ".next");
+
+    const auto trace = readFile();
+    EXPECT_EQ(countOf(trace, "\"name\":\"MATCHING\""), 2u) << "The hops should be written once per request:\n" << trace;
+    EXPECT_EQ(countOf(trace, "\"ph\":\"X\""), 9u) << "3 request hops twice plus 3 responses:\n" << trace;
+}
+
+TEST(RequestTimingTest, KernelTimestampIsRebasedOntoTheGatewayClock) {
+    // The realtime clock is 5 us ahead of the gateway clock, the kernel received 3 us before the gateway
+    constexpr utils::Nanos tGatewayRx = 1'000'000;
+    constexpr utils::Nanos tRealtime = tGatewayRx + 5'000;
+    constexpr auto tKernelRx = rebaseKernelTimestamp(tRealtime - 3'000, tRealtime, tGatewayRx);
+
+    EXPECT_EQ(tGatewayRx - tKernelRx, 3'000) << "KERNEL_TO_GATEWAY should not include the offset of the clocks";
+}
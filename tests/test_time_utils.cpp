@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <ctime>
+#include <string>
+
+#include "lib/time_utils.h"
+
+using namespace utils;
+
+class TimeUtilsTest : public ::testing::Test {
+  protected:
+    /// @brief Reference formatting of the second, without the cache
+    [[nodiscard]] static std::string formatSecond(Nanos nanos) {
+        const auto time = static_cast<std::time_t>(nanos / NANOS_TO_SECS);
+        std::tm tm{};
+        localtime_r(&time, &tm);
+        std::array<char, 32> buffer{};
+        const auto length = std::strftime(buffer.data(), buffer.size(), "%Y-%m-%d %H:%M:%S", &tm);
+        return {buffer.data(), length};
+    }
+
+    TimestampFormatter formatter;
+};
+
+TEST_F(TimeUtilsTest, FormatsNanosecondTimestamps) {
+    const Nanos second = 1'700'000'000 * NANOS_TO_SECS;
+
+    EXPECT_EQ(formatter.format(second + 123'456'789), formatSecond(second) + ".123456789");
+    EXPECT_EQ(formatter.format(second + 7), formatSecond(second) + ".000000007") << "Sub-second digits should be zero-padded";
+    EXPECT_EQ(formatter.format(second + 999'999'999), formatSecond(second) + ".999999999");
+    EXPECT_EQ(formatter.format(second).size(), TIMESTAMP_STR_LENGTH);
+}
+
+TEST_F(TimeUtilsTest, RefreshesTheCachedSecond) {
+    const Nanos second = 1'700'000'000 * NANOS_TO_SECS;
+
+    EXPECT_EQ(formatter.format(second + 5), formatSecond(second) + ".000000005");
+    EXPECT_EQ(formatter.format(second + NANOS_TO_SECS + 5), formatSecond(second + NANOS_TO_SECS) + ".000000005")
+        << "A new second should be formatted";
+    EXPECT_EQ(formatter.format(second + 86'400 * NANOS_TO_SECS), formatSecond(second + 86'400 * NANOS_TO_SECS) + ".000000000")
+        << "A new day should be formatted";
+    EXPECT_EQ(formatter.format(second + 1), formatSecond(second) + ".000000001") << "Going back in time should be formatted";
+}
+
+TEST_F(TimeUtilsTest, ConvertsNanosToTimeStr) {
+    const auto now = getCurrentNanos();
+    const auto str = convertNanosToTimeStr(now);
+
+    EXPECT_EQ(str.size(), TIMESTAMP_STR_LENGTH);
+    EXPECT_EQ(str.substr(0, 19), formatSecond(now));
+    EXPECT_EQ(std::stoll(str.substr(20)), now % NANOS_TO_SECS);
+}
+
+TEST_F(TimeUtilsTest, ReadsTheRealtimeClock) {
+    const auto toNanos = [](std::chrono::system_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    };
+    const auto before = toNanos(std::chrono::system_clock::now());
+    const auto realtime = getRealtimeNanos();
+    const auto after = toNanos(std::chrono::system_clock::now());
+
+    EXPECT_LE(before, realtime);
+    EXPECT_LE(realtime, after);
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include "lib/tsc_clock.h"
+
+using namespace utils;
+
+class TscClockTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        if (!TscClock::calibrate()) {
+            GTEST_SKIP() << "No invariant TSC";
+        }
+    }
+
+    [[nodiscard]] static std::int64_t systemNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+};
+
+TEST_F(TscClockTest, TracksTheSystemClock) {
+    EXPECT_TRUE(TscClock::isCalibrated());
+    EXPECT_GT(TscClock::getTicksPerSecond(), 1e6) << "The TSC should tick at least at 1 MHz";
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const auto difference = TscClock::now() - systemNanos();
+    EXPECT_LT(std::llabs(difference), 1'000'000) << "The TSC clock should be within 1 ms of the system clock";
+}
+
+TEST_F(TscClockTest, StaysMonotonicAcrossRecalibrations) {
+    auto previous = TscClock::now();
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(TscClock::recalibrate());
+        for (int j = 0; j < 1000; ++j) {
+            const auto now = TscClock::now();
+            ASSERT_GE(now, previous) << "The clock should never go back";
+            previous = now;
+        }
+    }
+}
+
+TEST_F(TscClockTest, ConvertsTicksToNanos) {
+    const auto start = readTsc();
+    const auto startNanos = systemNanos();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const auto elapsedNanos = systemNanos() - startNanos;
+    const auto elapsed = TscClock::ticksToNanos(readTscOrdered() - start);
+
+    EXPECT_NEAR(static_cast<double>(elapsed), static_cast<double>(elapsedNanos), 1e6)
+        << "Ticks should convert to the elapsed time";
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "lib/lock_free_queue.h"
+#include "lib/wait_strategy.h"
+
+using namespace utils;
+
+class WaitStrategyTest : public ::testing::Test {
+  protected:
+    /// @brief Long enough that a test relying on the park timeout instead of a wake-up fails
+    static constexpr std::chrono::seconds LONG_PARK{30};
+
+    /**
+     * @brief Pops nValues values on a consumer thread waiting with the strategy, returns their sum.
+     */
+    static std::uint64_t consume(LFQueue<std::uint64_t>& queue, WaitStrategy strategy, WaitSignal* signal, std::size_t nValues) {
+        std::uint64_t sum = 0;
+        std::jthread consumer([&]() {
+            Waiter waiter(strategy, signal, LONG_PARK);
+            for (std::size_t nPopped = 0; nPopped < nValues;) {
+                if (auto value = queue.pop()) {
+                    sum += *value;
+                    ++nPopped;
+                    waiter.reset();
+                } else {
+                    waiter.idle([&]() { return queue.getNextToRead() != nullptr; });
+                }
+            }
+        });
+
+        for (std::uint64_t value = 1; value <= nValues; ++value) {
+            // Let the consumer go through its spinning phase and park now and then
+            if (value % 16 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            while (!queue.push(value)) {
+                std::this_thread::yield();
+            }
+        }
+        consumer.join();
+        return sum;
+    }
+};
+
+TEST_F(WaitStrategyTest, EveryStrategyConsumesAllValues) {
+    constexpr std::size_t N_VALUES = 256;
+    for (const auto strategy : {WaitStrategy::BUSY_SPIN, WaitStrategy::SPIN_PAUSE, WaitStrategy::SPIN_YIELD}) {
+        LFQueue<std::uint64_t> queue(8);
+        EXPECT_EQ(consume(queue, strategy, nullptr, N_VALUES), N_VALUES * (N_VALUES + 1) / 2)
+            << "Lost values with " << waitStrategyToStr(strategy);
+    }
+}
+
+TEST_F(WaitStrategyTest, ParkedConsumerIsWokenByProducer) {
+    constexpr std::size_t N_VALUES = 256;
+    LFQueue<std::uint64_t> queue(8);
+    WaitSignal signal;
+    queue.setWaitSignal(&signal);
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(consume(queue, WaitStrategy::SPIN_PARK, &signal, N_VALUES), N_VALUES * (N_VALUES + 1) / 2);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, LONG_PARK) << "The consumer waited for the park timeout";
+}
+
+TEST_F(WaitStrategyTest, WakeEndsPark) {
+    WaitSignal signal;
+    std::atomic<bool> isStopped{false};
+    std::jthread waiting([&]() {
+        Waiter waiter(WaitStrategy::SPIN_PARK, &signal, LONG_PARK);
+        while (!isStopped.load()) {
+            waiter.idle([&]() { return isStopped.load(); });
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const auto start = std::chrono::steady_clock::now();
+    isStopped = true;
+    signal.wake();
+    waiting.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5)) << "wake() did not end the park";
+}
+
+TEST_F(WaitStrategyTest, UnsignalledParkTimesOut) {
+    Waiter waiter(WaitStrategy::SPIN_PARK, nullptr, std::chrono::milliseconds(1));
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint32_t i = 0; i < WAIT_SPIN_LIMIT + WAIT_YIELD_LIMIT + 8; ++i) {
+        waiter.idle([]() { return false; });
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
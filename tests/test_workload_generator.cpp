@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <map>
+#include <vector>
+
+#include "core/workload/workload_generator.h"
+#include "core/workload/workload_io.h"
+
+using namespace Workload;
+using Exchange::OMEClientRequest;
+
+class WorkloadGeneratorTest : public ::testing::Test {
+  protected:
+    [[nodiscard]] static WorkloadConfig makeConfig(std::uint64_t seed) {
+        WorkloadConfig config;
+        config.seed = seed;
+        config.nTickers = 2;
+        config.clients = {ClientProfile{.clientId = 1, .weight = 3.0, .cancelProbability = 0.5},
+                          ClientProfile{.clientId = 2, .weight = 1.0, .cancelProbability = 0.0, .aggressiveProbability = 0.5,
+                                        .qtyDistribution = QtyDistribution::UNIFORM, .minQty = 10, .maxQty = 20}};
+        return config;
+    }
+
+    [[nodiscard]] static std::vector<WorkloadRequest> generate(const WorkloadConfig& config, std::size_t nRequests) {
+        WorkloadGenerator generator(config);
+        std::vector<WorkloadRequest> requests;
+        generator.generate(nRequests, requests);
+        return requests;
+    }
+};
+
+TEST_F(WorkloadGeneratorTest, IsDeterministic) {
+    const auto requests = generate(makeConfig(7), 10'000);
+    const auto same = generate(makeConfig(7), 10'000);
+    const auto other = generate(makeConfig(8), 10'000);
+
+    ASSERT_EQ(requests.size(), same.size());
+    bool isOtherDifferent = false;
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        ASSERT_EQ(requests[i].tArrival, same[i].tArrival) << "Request " << i << " should arrive at the same time with the same seed";
+        ASSERT_EQ(requests[i].request, same[i].request) << "Request " << i << " should be the same with the same seed";
+        isOtherDifferent |= !(requests[i].request == other[i].request);
+    }
+    EXPECT_TRUE(isOtherDifferent) << "Another seed should give another flow";
+}
+
+TEST_F(WorkloadGeneratorTest, FollowsTheClientProfiles) {
+    constexpr std::size_t N_REQUESTS = 100'000;
+    const auto requests = generate(makeConfig(1), N_REQUESTS);
+
+    std::map<Exchange::ClientID, std::size_t> nRequests;
+    std::map<Exchange::ClientID, std::size_t> nCancels;
+    std::map<std::pair<Exchange::ClientID, Exchange::OrderID>, OMEClientRequest> newOrders;
+    utils::Nanos tPrevious = 0;
+    for (const auto& [tArrival, request] : requests) {
+        ASSERT_GE(tArrival, tPrevious) << "Arrival times should not decrease";
+        tPrevious = tArrival;
+        ++nRequests[request.clientId];
+        if (request.type == OMEClientRequest::Type::CANCEL) {
+            ++nCancels[request.clientId];
+            const auto order = newOrders.find({request.clientId, request.orderId});
+            ASSERT_NE(order, newOrders.end()) << "Cancels should target an earlier order of the client";
+            EXPECT_EQ(order->second.tickerId, request.tickerId);
+            newOrders.erase(order);
+        } else {
+            ASSERT_EQ(request.type, OMEClientRequest::Type::NEW);
+            ASSERT_LT(request.tickerId, 2u);
+            ASSERT_TRUE(newOrders.emplace(std::pair{request.clientId, request.orderId}, request).second) << "Order IDs should be unique per client";
+            ASSERT_LE(std::llabs(request.price - 10'000), 200) << "Prices should stay around the mid";
+            if (request.clientId == 2) {
+                ASSERT_GE(request.qty, 10u);
+                ASSERT_LE(request.qty, 20u);
+            }
+        }
+    }
+
+    EXPECT_NEAR(static_cast<double>(nRequests[1]) / N_REQUESTS, 0.75, 0.01) << "Clients should send requests in proportion to their weight";
+    EXPECT_EQ(nCancels[2], 0u);
+    EXPECT_GT(nCancels[1], nRequests[1] * 4 / 10) << "Client 1 should cancel about half of the time";
+    EXPECT_NEAR(static_cast<double>(tPrevious) / N_REQUESTS, 10'000.0, 200.0) << "Requests should arrive at 100k per second on average";
+}
+
+TEST_F(WorkloadGeneratorTest, RoundTripsThroughFilesAndQueues) {
+    const auto path = (std::filesystem::temp_directory_path() /
+                       std::format("workload_{}.bin", std::chrono::system_clock::now().time_since_epoch().count())).string();
+    WorkloadGenerator generator(makeConfig(3));
+    ASSERT_TRUE(writeWorkloadFile(path, generator, 5'000));
+
+    std::vector<WorkloadRequest> read;
+    ASSERT_TRUE(readWorkloadFile(path, read));
+    std::filesystem::remove(path);
+    const auto expected = generate(makeConfig(3), 5'000);
+    ASSERT_EQ(read.size(), expected.size());
+    for (std::size_t i = 0; i < read.size(); ++i) {
+        ASSERT_EQ(read[i].tArrival, expected[i].tArrival) << "Request " << i;
+        ASSERT_EQ(read[i].request, expected[i].request) << "Request " << i;
+    }
+
+    Exchange::ClientRequestQueue queue{8'192};
+    feedRequestQueue(queue, read, false);
+    for (const auto& [tArrival, request] : read) {
+        const auto queued = queue.pop();
+        ASSERT_TRUE(queued.has_value());
+        EXPECT_EQ(queued->request, request);
+        EXPECT_NE(queued->timing.tSequenced, 0) << "Fed requests should be stamped as sequenced";
+    }
+    EXPECT_FALSE(queue.pop().has_value());
+}